@@ -0,0 +1,50 @@
+/**
+ * Random malloc/free traffic of small blocks through MemBuf, the BCC
+ * allocator, and through the C library's allocator for reference. Run with
+ * an optional number of operations.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "malloc.h"
+
+#define LIVE_BLOCKS 16
+
+static double secondsSince(const struct timespec* start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void run(const char* name, void* (*alloc)(size_t), void (*release)(void*),
+                long ops) {
+  void* live[LIVE_BLOCKS] = {NULL};
+  struct timespec start;
+  long failed = 0;
+  long i;
+  srand(3);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < ops; ++i) {
+    int slot = rand() % LIVE_BLOCKS;
+    if (live[slot]) {
+      release(live[slot]);
+      live[slot] = NULL;
+    } else {
+      live[slot] = alloc(1 + rand() % 96);
+      failed += live[slot] == NULL;
+    }
+  }
+  for (i = 0; i < LIVE_BLOCKS; ++i) {
+    release(live[i]);
+  }
+  printf("%-16s %8.3f s %8.1f Mops/s (%ld failed)\n", name, secondsSince(&start),
+         ops / secondsSince(&start) / 1e6, failed);
+}
+
+int main(int argc, char** argv) {
+  long ops = argc > 1 ? atol(argv[1]) : 10000000;
+  run("MemBuf", MemBuf_malloc, MemBuf_free, ops);
+  run("libc malloc", malloc, free, ops);
+  return 0;
+}
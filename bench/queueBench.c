@@ -0,0 +1,174 @@
+/**
+ * Throughput of the lock-free queues against a LinkedList behind a mutex.
+ * Run with an optional number of producer (and as many consumer) threads and
+ * an optional number of elements per producer.
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "concurrentQueue.h"
+#include "linkedList.h"
+#include "ringBuffer.h"
+
+typedef struct Bench {
+  const char* name;
+  bool (*push)(void* queue, const long* item);
+  bool (*pop)(void* queue, long* item);
+  void* queue;
+  long perThread;
+} Bench;
+
+typedef struct LockedList {
+  pthread_mutex_t lock;
+  LinkedList list;
+} LockedList;
+
+static bool lockedPush(void* queue, const long* item) {
+  LockedList* locked = (LockedList*) queue;
+  SystemErr se = S_E_CLEAR;
+  pthread_mutex_lock(&locked->lock);
+  LinkedList_append(&locked->list, item, &se);
+  pthread_mutex_unlock(&locked->lock);
+  return true;
+}
+
+static bool lockedPop(void* queue, long* item) {
+  LockedList* locked = (LockedList*) queue;
+  bool popped = false;
+  pthread_mutex_lock(&locked->lock);
+  if (locked->list.length) {
+    *item = *(long*) LinkedList_first(&locked->list);
+    LinkedList_removeFirst(&locked->list);
+    popped = true;
+  }
+  pthread_mutex_unlock(&locked->lock);
+  return popped;
+}
+
+static bool spscPush(void* queue, const long* item) {
+  return SpscRingBuffer_push((SpscRingBuffer*) queue, item);
+}
+
+static bool spscPop(void* queue, long* item) {
+  return SpscRingBuffer_pop((SpscRingBuffer*) queue, item);
+}
+
+static bool mpmcPush(void* queue, const long* item) {
+  return MpmcRingBuffer_push((MpmcRingBuffer*) queue, item);
+}
+
+static bool mpmcPop(void* queue, long* item) {
+  return MpmcRingBuffer_pop((MpmcRingBuffer*) queue, item);
+}
+
+static bool msPush(void* queue, const long* item) {
+  Err se;
+  se.any = false;
+  ConcurrentQueue_push((ConcurrentQueue*) queue, item, &se);
+  return !se.any;
+}
+
+static bool msPop(void* queue, long* item) {
+  return ConcurrentQueue_pop((ConcurrentQueue*) queue, item);
+}
+
+static void* produce(void* arg) {
+  Bench* bench = (Bench*) arg;
+  long i;
+  for (i = 0; i < bench->perThread; ++i) {
+    while (!bench->push(bench->queue, &i)) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void* consume(void* arg) {
+  Bench* bench = (Bench*) arg;
+  long i;
+  long item;
+  long sum = 0;
+  for (i = 0; i < bench->perThread; ++i) {
+    while (!bench->pop(bench->queue, &item)) {
+      sched_yield();
+    }
+    sum += item;
+  }
+  return (void*) sum;
+}
+
+static void run(Bench* bench, int threads) {
+  pthread_t* workers = (pthread_t*) malloc(2 * threads * sizeof(pthread_t));
+  struct timespec start;
+  struct timespec end;
+  double seconds;
+  int i;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < threads; ++i) {
+    pthread_create(&workers[i], NULL, produce, bench);
+    pthread_create(&workers[threads + i], NULL, consume, bench);
+  }
+  for (i = 0; i < 2 * threads; ++i) {
+    pthread_join(workers[i], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("%-28s %2d+%-2d threads %8.3f s %9.2f Mops/s\n", bench->name, threads,
+         threads, seconds, threads * bench->perThread / seconds / 1e6);
+  free(workers);
+}
+
+int main(int argc, char** argv) {
+  int threads = argc > 1 ? atoi(argv[1]) : 4;
+  long perThread = argc > 2 ? atol(argv[2]) : 1000000;
+  Err se;
+  LockedList locked;
+  SpscRingBuffer spsc;
+  MpmcRingBuffer mpmc;
+  ConcurrentQueue ms;
+  Bench bench;
+  se.any = false;
+  bench.perThread = perThread;
+
+  pthread_mutex_init(&locked.lock, NULL);
+  initLinkedList(&locked.list, sizeof(long), NULL, NULL);
+  bench.name = "LinkedList + mutex";
+  bench.push = lockedPush;
+  bench.pop = lockedPop;
+  bench.queue = &locked;
+  run(&bench, threads);
+  deinitLinkedList(&locked.list);
+  pthread_mutex_destroy(&locked.lock);
+
+  initMpmcRingBuffer(&mpmc, sizeof(long), 1024, &se);
+  bench.name = "MpmcRingBuffer";
+  bench.push = mpmcPush;
+  bench.pop = mpmcPop;
+  bench.queue = &mpmc;
+  run(&bench, threads);
+  deinitMpmcRingBuffer(&mpmc);
+
+  initConcurrentQueue(&ms, sizeof(long), &se);
+  bench.name = "ConcurrentQueue";
+  bench.push = msPush;
+  bench.pop = msPop;
+  bench.queue = &ms;
+  run(&bench, threads);
+  deinitConcurrentQueue(&ms);
+
+  initSpscRingBuffer(&spsc, sizeof(long), 1024, &se);
+  bench.name = "SpscRingBuffer";
+  bench.push = spscPush;
+  bench.pop = spscPop;
+  bench.queue = &spsc;
+  run(&bench, 1);
+  deinitSpscRingBuffer(&spsc);
+
+  if (se.any) {
+    raiseError(&se);
+  }
+  return 0;
+}
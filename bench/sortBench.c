@@ -0,0 +1,97 @@
+/**
+ * Sorts the same random ints with qsort() for reference, Vector_sort(),
+ * Vector_parallelSort() and the Vector_sortInts() radix sort, then random
+ * doubles with qsort() and Vector_sortDoubles(). Run with an optional number
+ * of elements and threads.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vector.h"
+#include "vectorSort.h"
+
+static double secondsSince(const struct timespec* start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int cmpInt(const void* a, const void* b) {
+  int x = *(const int*) a;
+  int y = *(const int*) b;
+  return (x > y) - (x < y);
+}
+
+static int cmpDouble(const void* a, const void* b) {
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+static void report(const char* name, const struct timespec* start, long n) {
+  printf("%-20s %8.3f s %8.1f Melems/s\n", name, secondsSince(start),
+         n / secondsSince(start) / 1e6);
+}
+
+int main(int argc, char** argv) {
+  long n = argc > 1 ? atol(argv[1]) : 10000000;
+  uint threads = argc > 2 ? (uint) atoi(argv[2]) : 0;
+  Err se;
+  Vector source;
+  Vector v;
+  struct timespec start;
+  long i;
+  se.any = false;
+  srand(3);
+
+  initIntVector(&source, NULL, 0, &se);
+  Vector_reserve(&source, n, &se);
+  for (i = 0; i < n; ++i) {
+    int item = rand() - RAND_MAX / 2;
+    Vector_add(&source, &item, &se);
+  }
+
+  initVectorCp(&v, &source, &se);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  qsort(v.arr, v.length, sizeof(int), cmpInt);
+  report("qsort int", &start, n);
+
+  memcpy(v.arr, source.arr, n * sizeof(int));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Vector_sort(&v, cmpInt);
+  report("Vector_sort", &start, n);
+
+  memcpy(v.arr, source.arr, n * sizeof(int));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Vector_parallelSort(&v, cmpInt, threads, &se);
+  report("Vector_parallelSort", &start, n);
+
+  memcpy(v.arr, source.arr, n * sizeof(int));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Vector_sortInts(&v, &se);
+  report("Vector_sortInts", &start, n);
+  deinitVector(&v);
+  deinitVector(&source);
+
+  initDoubleVector(&source, NULL, 0, &se);
+  Vector_reserve(&source, n, &se);
+  for (i = 0; i < n; ++i) {
+    double item = (rand() - RAND_MAX / 2) / 1000.0;
+    Vector_add(&source, &item, &se);
+  }
+
+  initVectorCp(&v, &source, &se);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  qsort(v.arr, v.length, sizeof(double), cmpDouble);
+  report("qsort double", &start, n);
+
+  memcpy(v.arr, source.arr, n * sizeof(double));
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  Vector_sortDoubles(&v, &se);
+  report("Vector_sortDoubles", &start, n);
+  deinitVector(&v);
+  deinitVector(&source);
+  return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * Compares the SIMD String searching functions against the strtok() and
+ * byte at a time paths they replace. Run with an optional buffer size in MiB.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stringVector.h"
+
+static double secondsSince(const struct timespec* start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char* name, double seconds, size_t bytes) {
+  printf("%-28s %8.3f s %9.1f MiB/s\n", name, seconds,
+         bytes / seconds / (1 << 20));
+}
+
+int main(int argc, char** argv) {
+  size_t mib = argc > 1 ? (size_t) atoi(argv[1]) : 64;
+  size_t len = mib << 20;
+  size_t i;
+  size_t count = 0;
+  struct timespec start;
+  Err se;
+  String buf;
+  Vector tokens;
+  Vector views;
+  se.any = false;
+
+  initString(&buf, "", &se);
+  Vector_reserve(&buf, len, &se);
+  srand(1);
+  for (i = 0; i < len; ++i) {
+    int r = rand() % 64;
+    ((char*) buf.arr)[i] = r == 0 ? '\n' : r < 4 ? ',' : r < 6 ? ' ' : 'a' + r % 26;
+  }
+  buf.length = len;
+  _Vector_appendNull(&buf);
+  if (se.any) {
+    raiseError(&se);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < len; ++i) {
+    count += ((char*) buf.arr)[i] == '\n';
+  }
+  report("count newlines, bytewise", secondsSince(&start), len);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  count -= String_count(&buf, '\n');
+  report("String_count", secondsSince(&start), len);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  count += strstr(buf.arr, "zzzzzz") != NULL;
+  report("strstr", secondsSince(&start), len);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  count += String_find(&buf, "zzzzzz", 0) != STRING_NPOS;
+  report("String_find", secondsSince(&start), len);
+
+  initVector(&tokens, sizeof(String), NULL, (void (*)(void*)) &deinitString, &se);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  String_tok(&buf, &tokens, ", \n", &se);
+  report("String_tok (strtok)", secondsSince(&start), len);
+
+  initVector(&views, sizeof(StringView), NULL, NULL, &se);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  String_tokView(&buf, &views, ", \n", &se);
+  report("String_tokView", secondsSince(&start), len);
+  count += tokens.length - views.length;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  String_split(&buf, &views, ", \n", &se);
+  report("String_split", secondsSince(&start), len);
+
+  if (se.any) {
+    raiseError(&se);
+  }
+  printf("checksum %lu\n", (unsigned long) count);
+
+  deinitVector(&views);
+  deinitVector(&tokens);
+  deinitString(&buf);
+  return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * Fills and sums a Vector of int and a Vector of double through the type
+ * erased Vector functions, and through the DEFINE_VECTOR() generated Ints
+ * and Doubles. Run with an optional number of elements.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "typedVector.h"
+#include "vector.h"
+
+#define ROUNDS 20
+
+static double secondsSince(const struct timespec* start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char* name, const struct timespec* start, long n,
+                   double check) {
+  printf("%-16s %8.3f s %8.1f Melems/s (%g)\n", name, secondsSince(start),
+         n * ROUNDS / secondsSince(start) / 1e6, check);
+}
+
+static void runErased(long n) {
+  Err se;
+  Vector ints;
+  Vector doubles;
+  struct timespec start;
+  double sum = 0;
+  long r;
+  long i;
+  se.any = false;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (r = 0; r < ROUNDS; ++r) {
+    initIntVector(&ints, NULL, 0, &se);
+    for (i = 0; i < n; ++i) {
+      int item = (int) i;
+      Vector_add(&ints, &item, &se);
+    }
+    for (i = 0; i < n; ++i) {
+      sum += *(int*) Vector_at(&ints, i, &se);
+    }
+    deinitVector(&ints);
+  }
+  report("Vector int", &start, n, sum);
+
+  sum = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (r = 0; r < ROUNDS; ++r) {
+    initDoubleVector(&doubles, NULL, 0, &se);
+    for (i = 0; i < n; ++i) {
+      double item = i * 0.5;
+      Vector_add(&doubles, &item, &se);
+    }
+    for (i = 0; i < n; ++i) {
+      sum += *(double*) Vector_at(&doubles, i, &se);
+    }
+    deinitVector(&doubles);
+  }
+  report("Vector double", &start, n, sum);
+}
+
+static void runTyped(long n) {
+  Err se;
+  Ints ints;
+  Doubles doubles;
+  struct timespec start;
+  double sum = 0;
+  long r;
+  long i;
+  se.any = false;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (r = 0; r < ROUNDS; ++r) {
+    long intSum = 0;
+    initInts(&ints, &se);
+    for (i = 0; i < n; ++i) {
+      Ints_add(&ints, (int) i, &se);
+    }
+    for (i = 0; i < n; ++i) {
+      intSum += *Ints_get(&ints, i);
+    }
+    sum += intSum;
+    deinitInts(&ints);
+  }
+  report("Ints", &start, n, sum);
+
+  sum = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (r = 0; r < ROUNDS; ++r) {
+    initDoubles(&doubles, &se);
+    for (i = 0; i < n; ++i) {
+      Doubles_add(&doubles, i * 0.5, &se);
+    }
+    for (i = 0; i < n; ++i) {
+      sum += *Doubles_get(&doubles, i);
+    }
+    deinitDoubles(&doubles);
+  }
+  report("Doubles", &start, n, sum);
+}
+
+int main(int argc, char** argv) {
+  long n = argc > 1 ? atol(argv[1]) : 1000000;
+  runErased(n);
+  runTyped(n);
+  return 0;
+}
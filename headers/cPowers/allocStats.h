@@ -0,0 +1,59 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include "types.h"
+
+#include "systemError.h"
+#include "stringVector.h"
+
+/**
+ * AllocStats keeps count of what the containers ask for, per kind of
+ * container, so default sizes can be picked from real data. Counting is off
+ * until AllocStats_setEnabled() turns it on, and costs a branch per
+ * allocation until then. Blocks from before then only show up once they're
+ * resized or released, and never take bytesInUse below 0. It's safe to count
+ * from several threads at once, but the counters are only a loose snapshot
+ * while they're being updated.
+ */
+
+// Block sizes are bucketed by power of two, bucket b holds [2^b, 2^(b+1))
+#if __BCC__
+#define ALLOC_STATS_BUCKETS 16
+#else
+#define ALLOC_STATS_BUCKETS 32
+#endif
+
+typedef enum AllocKind {
+  ALLOC_KIND_OTHER,
+  ALLOC_KIND_VECTOR,
+  ALLOC_KIND_STRING,
+  ALLOC_KIND_LINKED_LIST,
+  ALLOC_KIND_HASH_MAP,
+  ALLOC_KINDS
+} AllocKind;
+
+typedef struct AllocStats {
+  ulong allocs;
+  ulong reallocs;
+  ulong frees;
+  ulong bytesRequested; // Every size given to an alloc or a realloc
+  ulong bytesInUse;
+  ulong peakBytesInUse;
+  ulong reallocCopyBytes; // Bytes moved by reallocs that didn't stay in place
+  ulong sizeHistogram[ALLOC_STATS_BUCKETS]; // Allocs and reallocs by new size
+} AllocStats;
+
+void AllocStats_setEnabled(bool);
+bool AllocStats_enabled();
+void AllocStats_reset();
+AllocStats* AllocStats_get(AllocKind, AllocStats*);
+const char* AllocStats_kindName(AllocKind);
+void AllocStats_toJson(String*, SystemErrNoMems*);
+
+void AllocStats_recordAlloc(AllocKind, size_t size);
+void AllocStats_recordResize(AllocKind, size_t oldSize, size_t size, bool moved);
+void AllocStats_recordRelease(AllocKind, size_t size);
+
+uint _AllocStats_bucketOf(size_t size);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include "types.h"
+
+#include "malloc.h"
+
+/**
+ * Allocator is where a container gets its memory from, e.g. an arena, a
+ * pool, or something that keeps count. [alloc], [resize] and [release] work
+ * like malloc(), realloc() and free(), but they're also told the size of
+ * the block being resized or released so an allocator doesn't need to
+ * keep track of it. [context] is passed to each of them.
+ *
+ * Containers take a pointer to an Allocator, which must outlive them. NULL
+ * means the global allocator, malloc() and friends.
+ */
+typedef struct Allocator {
+  void* (*alloc)(void* context, size_t size);
+  void* (*resize)(void* context, void* ptr, size_t oldSize, size_t size);
+  void (*release)(void* context, void* ptr, size_t size);
+  void* context;
+} Allocator;
+
+extern const Allocator ALLOCATOR_GLOBAL;
+
+void* Allocator_alloc(const Allocator*, size_t size);
+void* Allocator_resize(const Allocator*, void* ptr, size_t oldSize, size_t size);
+void Allocator_release(const Allocator*, void* ptr, size_t size);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+
+#include "allocator.h"
+#include "stringVector.h"
+#include "systemError.h"
+#include "vector.h"
+
+#define ARENA_ALIGN 16
+#define ARENA_DEFAULT_CHUNK_SIZE ((size_t) 64 << 10)
+
+typedef struct ArenaChunk ArenaChunk;
+
+/**
+ * Arena hands out memory by bumping a pointer through big chunks, and takes
+ * it all back at once with Arena_reset() or back to an earlier
+ * Arena_mark() with Arena_rollback(). Chunks given back are kept for reuse
+ * until the arena is deinitialized, so an arena reset after every request
+ * stops calling malloc() once it has seen its biggest request.
+ *
+ * [allocator] puts containers in the arena, e.g.
+ * initVectorWithAllocator(..., &arena.allocator, se). Releasing memory to it
+ * only does anything for the most recent allocation, and the most recent
+ * allocation also grows in place, so a lone growing Vector never copies.
+ * Containers whose memory is all in the arena don't need deinitializing
+ * before a reset. The arena can't be moved once initialized since
+ * [allocator] points back at it.
+ */
+typedef struct Arena {
+  Allocator allocator;
+  size_t chunkSize;
+
+  // Privates. No touchy!
+  ArenaChunk* _chunk; // Chunk being bumped through, linked to the older ones
+  char* _bump;
+  char* _end;
+  ArenaChunk* _spareChunks; // Given back by a reset or rollback
+} Arena;
+
+struct ArenaChunk {
+  ArenaChunk* prev;
+  size_t size; // Bytes of data
+  union {
+    long double ld;
+    long long ll;
+    void* p;
+  } data[];
+};
+
+/**
+ * A point in an arena's allocations to roll back to.
+ */
+typedef struct ArenaMark {
+  ArenaChunk* chunk;
+  char* bump;
+} ArenaMark;
+
+Arena* initArena(Arena*, size_t chunkSize);
+void deinitArena(Arena*);
+
+void* Arena_alloc(Arena*, size_t, SystemErrNoMems*);
+ArenaMark* Arena_mark(const Arena*, ArenaMark*);
+void Arena_rollback(Arena*, const ArenaMark*);
+void Arena_reset(Arena*);
+
+Vector* Arena_newVector(Arena*, size_t, void* (*)(void*, const void*, Err*),
+                        void (*)(void*), SystemErrNoMems*);
+String* Arena_newString(Arena*, const char*, SystemErrNoMems*);
+
+void* _Arena_bump(Arena*, size_t);
+bool _Arena_newChunk(Arena*, size_t);
+void* _Arena_allocatorAlloc(void* arena, size_t size);
+void* _Arena_allocatorResize(void* arena, void* ptr, size_t oldSize, size_t size);
+void _Arena_allocatorRelease(void* arena, void* ptr, size_t size);
+
+#endif
+#endif
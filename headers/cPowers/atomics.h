@@ -0,0 +1,26 @@
+#ifndef ATOMICS_H
+#define ATOMICS_H
+
+#ifndef __BCC__
+
+/**
+ * CP_ATOMIC(T) declares an atomic T that C and C++ agree on, so the
+ * concurrent containers can be declared from C++ code too. Only the C side
+ * ever operates on them.
+ */
+#ifdef __cplusplus
+extern "C++" {
+#include <atomic>
+}
+#define CP_ATOMIC(T) std::atomic<T>
+#else
+#include <stdatomic.h>
+#define CP_ATOMIC(T) _Atomic(T)
+#endif
+
+// Padding between fields written by different threads keeps them from
+// bouncing the same cache line back and forth.
+#define CP_CACHE_LINE 64
+
+#endif
+#endif
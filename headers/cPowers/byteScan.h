@@ -0,0 +1,33 @@
+#ifndef BYTE_SCAN_H
+#define BYTE_SCAN_H
+
+#include "types.h"
+
+#define BYTE_SET_MAX_SIMD_CHARS 16
+
+/**
+ * ByteScan holds the raw search kernels behind the String and StringView
+ * searching functions. On x86-64 they use SSE2, or AVX2 when the CPU has it,
+ * and fall back to plain loops everywhere else. Every function returns [len]
+ * when nothing is found.
+ */
+
+/**
+ * A set of bytes to search for, prepared once and reused. Sets of up to
+ * BYTE_SET_MAX_SIMD_CHARS bytes are searched with SIMD.
+ */
+typedef struct ByteSet {
+  bool contains[256];
+  char chars[BYTE_SET_MAX_SIMD_CHARS];
+  size_t numChars; // > BYTE_SET_MAX_SIMD_CHARS when only [contains] is usable
+} ByteSet;
+
+ByteSet* initByteSet(ByteSet*, const char* chars);
+
+size_t ByteScan_count(const char* s, size_t len, char c);
+size_t ByteScan_find(const char* s, size_t len, const char* needle,
+                     size_t needleLen);
+size_t ByteScan_findAny(const char* s, size_t len, const ByteSet* set);
+size_t ByteScan_findChar(const char* s, size_t len, char c);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "atomics.h"
+#include "segmentedArray.h"
+#include "systemError.h"
+#include "types.h"
+
+#define CONCURRENT_QUEUE_FIRST_SEGMENT 64
+
+typedef struct ConcurrentQueueNode ConcurrentQueueNode;
+
+/**
+ * ConcurrentQueue is an unbounded lock-free FIFO (Michael & Scott) that any
+ * number of threads may push to and pop from. Elements are copied in and out
+ * bitwise, like the ring buffers.
+ *
+ * Nodes live in a SegmentedArray and are recycled through a lock-free free
+ * list instead of being freed, so a thread that's lagging behind can always
+ * safely read a node it found. Links are 32 bit node indexes tagged with a
+ * counter that changes on every update, which keeps a recycled node from
+ * being mistaken for the one that used to be there.
+ */
+typedef struct ConcurrentQueue {
+  // Privates. No touchy!
+  SegmentedArray _nodes;
+  size_t _typeSize;
+  size_t _nodeSize;
+  CP_ATOMIC(u32) _nodesUsed; // Nodes ever handed out, the rest are untouched
+  char _pad0[CP_CACHE_LINE];
+  CP_ATOMIC(u64) _head;      // Tagged link to the dummy node before the first
+  char _pad1[CP_CACHE_LINE];
+  CP_ATOMIC(u64) _tail;      // Tagged link to the last node, or close to it
+  char _pad2[CP_CACHE_LINE];
+  CP_ATOMIC(u64) _freeNodes; // Tagged link to the top of the free list
+  char _pad3[CP_CACHE_LINE];
+} ConcurrentQueue;
+
+struct ConcurrentQueueNode {
+  CP_ATOMIC(u64) next;
+  CP_ATOMIC(u64) nextFree;
+  // The node goes back on the free list once its element has been popped
+  // and it has stopped being the dummy, whichever comes last.
+  CP_ATOMIC(u32) refs;
+  union {
+    long double ld;
+    long long ll;
+    void* p;
+  } data[];
+};
+
+ConcurrentQueue* initConcurrentQueue(ConcurrentQueue*, size_t typeSize,
+                                     SystemErrNoMems*);
+void deinitConcurrentQueue(ConcurrentQueue*);
+
+void ConcurrentQueue_push(ConcurrentQueue*, const void* data, SystemErrNoMems*);
+bool ConcurrentQueue_pop(ConcurrentQueue*, void* out);
+
+u32 _ConcurrentQueue_allocNode(ConcurrentQueue*, SystemErrNoMems*);
+void _ConcurrentQueue_releaseNode(ConcurrentQueue*, u32 index);
+ConcurrentQueueNode* _ConcurrentQueue_node(ConcurrentQueue*, u32 index);
+
+#endif
+#endif
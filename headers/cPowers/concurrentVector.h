@@ -0,0 +1,58 @@
+#ifndef CONCURRENT_VECTOR_H
+#define CONCURRENT_VECTOR_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "atomics.h"
+#include "segmentedArray.h"
+#include "systemError.h"
+#include "types.h"
+#include "vector.h"
+
+/**
+ * ConcurrentVector is a Vector that any number of threads can add to and
+ * read from at the same time. Adding claims an index with one fetch_add, so
+ * adders never wait on each other. Elements live in a SegmentedArray and
+ * never move, so a pointer from ConcurrentVector_at() stays good until the
+ * vector is deinitialized.
+ *
+ * An element only shows up to readers once it's been fully copied in. An
+ * add that's still copying, or that failed, leaves a slot that
+ * ConcurrentVector_at() reports as out of range.
+ */
+typedef struct ConcurrentVector {
+  // Privates. No touchy!
+  SegmentedArray _elements;
+  SegmentedArray _ready; // One atomic u8 per element, set once it's copied in
+  void* (*_copyInitializer)(void*, const void*, Err*);
+  void (*_deInitializer)(void*);
+  size_t _typeSize;
+  char _pad0[CP_CACHE_LINE];
+  CP_ATOMIC(size_t) _length; // Indexes claimed so far
+  char _pad1[CP_CACHE_LINE];
+} ConcurrentVector;
+
+ConcurrentVector* initConcurrentVector(ConcurrentVector*, size_t,
+                                       void* (*)(void*, const void*, Err*),
+                                       void (*)(void*));
+ConcurrentVector* initConcurrentVectorAdvanced(ConcurrentVector*, size_t, size_t,
+                                               void* (*)(void*, const void*, Err*),
+                                               void (*)(void*));
+void deinitConcurrentVector(ConcurrentVector*);
+
+size_t ConcurrentVector_add(ConcurrentVector*, const void*, SystemErrNoMems*);
+size_t ConcurrentVector_catPrimitive(ConcurrentVector*, const void*, size_t,
+                                     SystemErrNoMems*);
+void* ConcurrentVector_at(ConcurrentVector*, size_t, VectorErrRange* e);
+void ConcurrentVector_forEach(ConcurrentVector*,
+                              void (*fn)(void* item, void* context),
+                              void* context);
+size_t ConcurrentVector_length(ConcurrentVector*);
+
+bool _ConcurrentVector_isReady(ConcurrentVector*, size_t);
+
+#endif
+#endif
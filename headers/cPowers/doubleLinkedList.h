@@ -0,0 +1,90 @@
+#ifndef DOUBLE_LINKED_LIST_H
+#define DOUBLE_LINKED_LIST_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+#include "nodePool.h"
+#include "systemError.h"
+
+typedef struct DoubleLinkedNode DoubleLinkedNode;
+
+/**
+ * DoubleLinkedList is a linked list with back pointers, so removing the last
+ * element, and inserting or removing at any node, is O(1). Nodes double as
+ * cursors. Elements are stored inline in their node like InlineList, and
+ * nodes can be moved between lists (splice, concat) without copying them.
+ */
+typedef struct DoubleLinkedList {
+  DoubleLinkedNode* firstNode;
+  DoubleLinkedNode* lastNode;
+  size_t length;
+
+  void* (*_copyInitializer)(void*, const void*, SystemErr*);
+  void (*_deInitializer)(void*);
+  size_t _typeSize;
+  NodePool* _pool; // Optional. Nodes are malloced when NULL.
+} DoubleLinkedList;
+
+struct DoubleLinkedNode {
+  DoubleLinkedNode* prev;
+  DoubleLinkedNode* next;
+  // The element itself, _typeSize bytes, aligned for any type
+  union {
+    long double ld;
+    long long ll;
+    void* p;
+  } data[];
+};
+
+DoubleLinkedList* initDoubleLinkedList(DoubleLinkedList*, size_t,
+                                       void* (*)(void*, const void*, SystemErr*),
+                                       void (*)(void*));
+DoubleLinkedList* initDoubleLinkedListCp(DoubleLinkedList*,
+                                         const DoubleLinkedList*, SystemErr*);
+DoubleLinkedList* initDoubleLinkedListPooled(DoubleLinkedList*, size_t,
+                                             void* (*)(void*, const void*, SystemErr*),
+                                             void (*)(void*), NodePool*);
+void deinitDoubleLinkedList(DoubleLinkedList*);
+
+void DoubleLinkedList_append(DoubleLinkedList*, const void* data, SystemErr*);
+void* DoubleLinkedList_appendEmpty(DoubleLinkedList*, SystemErr*);
+void DoubleLinkedList_prepend(DoubleLinkedList*, const void* data, SystemErr*);
+DoubleLinkedNode* DoubleLinkedList_insertAfter(DoubleLinkedList*, DoubleLinkedNode*,
+                                               const void* data, SystemErr*);
+DoubleLinkedNode* DoubleLinkedList_insertBefore(DoubleLinkedList*, DoubleLinkedNode*,
+                                                const void* data, SystemErr*);
+
+void* DoubleLinkedList_first(const DoubleLinkedList*);
+void* DoubleLinkedList_last(const DoubleLinkedList*);
+void DoubleLinkedList_clear(DoubleLinkedList*);
+
+void DoubleLinkedList_remove(DoubleLinkedList*, DoubleLinkedNode*);
+void DoubleLinkedList_removeFirst(DoubleLinkedList*);
+void DoubleLinkedList_removeLast(DoubleLinkedList*);
+
+void* DoubleLinkedList_find(DoubleLinkedList* list, void* dataToFind,
+                            bool (*cmp)(void* dataToFind, void* itemData),
+                            LLErr* le);
+DoubleLinkedNode* DoubleLinkedList_findNode(DoubleLinkedList* list, void* dataToFind,
+                                            bool (*cmp)(void* dataToFind, void* itemData),
+                                            LLErr* le);
+
+void DoubleLinkedList_concat(DoubleLinkedList*, DoubleLinkedList* other, LLErr*);
+void DoubleLinkedList_splice(DoubleLinkedList*, DoubleLinkedNode* before,
+                             DoubleLinkedList* other, DoubleLinkedNode* first,
+                             DoubleLinkedNode* last, LLErr*);
+
+DoubleLinkedNode* DoubleLinkedList_nodeOf(void* data);
+size_t DoubleLinkedList_nodeSize(size_t typeSize);
+
+void _DoubleLinkedList_link(DoubleLinkedList*, DoubleLinkedNode* before,
+                            DoubleLinkedNode* first, DoubleLinkedNode* last);
+void _DoubleLinkedList_unlink(DoubleLinkedList*, DoubleLinkedNode* first,
+                              DoubleLinkedNode* last);
+
+#endif
+#endif
@@ -0,0 +1,13 @@
+#ifndef HASH_H
+#define HASH_H
+
+#ifndef __BCC__
+
+#include "types.h"
+
+#define HASH_DEFAULT_SEED 0x243f6a8885a308d3ULL
+
+u64 Hash_bytes(const void* key, size_t len, u64 seed);
+
+#endif
+#endif
@@ -0,0 +1,100 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "stringVector.h"
+#include "stringView.h"
+#include "systemError.h"
+#include "types.h"
+
+#define HASH_MAP_GROUP 16 // Control bytes probed at once
+#define HASH_MAP_MIN_CAPACITY 16
+#define HASH_MAP_NPOS ((size_t) -1)
+
+/**
+ * HashMap maps keys of _keySize bytes to values of _valueSize bytes, the way
+ * Vector holds elements of _typeSize bytes. It's an open addressing table
+ * in the style of Swiss tables: keys and values sit side by side in one flat
+ * array, and a separate array of one byte per slot holds 7 bits of each
+ * key's hash. A lookup compares 16 of those control bytes at once and only
+ * calls [equals] on the rare slots that match, so a miss usually costs one
+ * SSE2 compare and no calls at all.
+ *
+ * A NULL hash function hashes the key bytes and a NULL [equals] compares the
+ * key bytes, which is right for any key that's plain data. Keys and values
+ * are copied bitwise unless copy initializers are set with
+ * HashMap_setKeyInitializers() and HashMap_setValueInitializers().
+ * initStringHashMap() sets all of that up for String keys.
+ *
+ * Pointers to keys and values are only good until the next insertion, which
+ * may rehash the table.
+ */
+typedef struct HashMap {
+  size_t length;
+
+  // Privates. No touchy!
+  u8* _ctrl;   // _capacity control bytes plus a copy of the first group
+  char* _slots; // _capacity slots, each a key then a value
+  size_t _capacity;
+  size_t _growthLeft; // Empty slots that may still be filled before a rehash
+  size_t _keySize;
+  size_t _valueSize;
+  size_t _valueOffset;
+  size_t _slotSize;
+  u64 (*_hash)(const void* key);
+  bool (*_equals)(const void* key, const void* otherKey);
+  void* (*_keyCopyInitializer)(void*, const void*, Err*);
+  void (*_keyDeInitializer)(void*);
+  void* (*_valueCopyInitializer)(void*, const void*, Err*);
+  void (*_valueDeInitializer)(void*);
+} HashMap;
+
+/**
+ * A HashSet is a HashMap without values.
+ */
+typedef HashMap HashSet;
+
+HashMap* initHashMap(HashMap*, size_t keySize, size_t valueSize,
+                     u64 (*hash)(const void*),
+                     bool (*equals)(const void*, const void*), SystemErrNoMems*);
+HashMap* initStringHashMap(HashMap*, size_t valueSize, SystemErrNoMems*);
+void deinitHashMap(HashMap*);
+
+void HashMap_setKeyInitializers(HashMap*, void* (*)(void*, const void*, Err*),
+                                void (*)(void*));
+void HashMap_setValueInitializers(HashMap*, void* (*)(void*, const void*, Err*),
+                                  void (*)(void*));
+
+void HashMap_clear(HashMap*);
+bool HashMap_contains(const HashMap*, const void* key);
+void* HashMap_emplace(HashMap*, const void* key, bool* inserted, SystemErrNoMems*);
+void* HashMap_get(const HashMap*, const void* key);
+void* HashMap_getView(const HashMap*, const StringView* key);
+bool HashMap_next(const HashMap*, size_t* iter, void** key, void** value);
+void* HashMap_put(HashMap*, const void* key, const void* value, SystemErrNoMems*);
+bool HashMap_remove(HashMap*, const void* key);
+void HashMap_reserve(HashMap*, size_t, SystemErrNoMems*);
+
+HashSet* initHashSet(HashSet*, size_t keySize, u64 (*hash)(const void*),
+                     bool (*equals)(const void*, const void*), SystemErrNoMems*);
+HashSet* initStringHashSet(HashSet*, SystemErrNoMems*);
+void deinitHashSet(HashSet*);
+
+bool HashSet_add(HashSet*, const void* key, SystemErrNoMems*);
+bool HashSet_contains(const HashSet*, const void* key);
+bool HashSet_remove(HashSet*, const void* key);
+
+size_t _HashMap_find(const HashMap*, const void* key, u64 hash,
+                     bool (*equals)(const void*, const void*));
+size_t _HashMap_findInsertSlot(const HashMap*, u64 hash);
+u64 _HashMap_hash(const HashMap*, const void* key);
+void* _HashMap_keyAt(const HashMap*, size_t index);
+void _HashMap_rehash(HashMap*, size_t capacity, SystemErrNoMems*);
+void _HashMap_setCtrl(HashMap*, size_t index, u8 ctrl);
+
+#endif
+#endif
@@ -0,0 +1,68 @@
+#ifndef INLINE_LIST_H
+#define INLINE_LIST_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+#include "nodePool.h"
+#include "systemError.h"
+
+typedef struct InlineNode InlineNode;
+
+/**
+ * InlineList works like LinkedList, except each element is stored right in
+ * its node instead of behind a data pointer. Walking the list touches one
+ * cache line per element instead of two, and every node is a single
+ * allocation.
+ */
+typedef struct InlineList {
+  InlineNode* firstNode;
+  InlineNode* lastNode;
+  size_t length;
+
+  void* (*_copyInitializer)(void*, const void*, SystemErr*);
+  void (*_deInitializer)(void*);
+  size_t _typeSize;
+  NodePool* _pool; // Optional. Nodes are malloced when NULL.
+} InlineList;
+
+struct InlineNode {
+  InlineNode* next;
+  // The element itself, _typeSize bytes, aligned for any type
+  union {
+    long double ld;
+    long long ll;
+    void* p;
+  } data[];
+};
+
+InlineList* initInlineList(InlineList*, size_t,
+                           void* (*)(void*, const void*, SystemErr*),
+                           void (*)(void*));
+InlineList* initInlineListCp(InlineList*, const InlineList*, SystemErr*);
+InlineList* initInlineListPooled(InlineList*, size_t,
+                                 void* (*)(void*, const void*, SystemErr*),
+                                 void (*)(void*), NodePool*);
+void deinitInlineList(InlineList*);
+
+void InlineList_append(InlineList*, const void* data, SystemErr*);
+void* InlineList_appendEmpty(InlineList*, SystemErr*);
+void InlineList_prepend(InlineList*, const void* data, SystemErr*);
+
+void* InlineList_first(const InlineList*);
+void* InlineList_last(const InlineList*);
+void InlineList_clear(InlineList*);
+
+void InlineList_removeFirst(InlineList*);
+void InlineList_removeLast(InlineList*);
+
+void* InlineList_find(InlineList* list, void* dataToFind,
+                      bool (*cmp)(void* dataToFind, void* itemData), LLErr* le);
+
+size_t InlineList_nodeSize(size_t typeSize);
+
+#endif
+#endif
@@ -0,0 +1,38 @@
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#ifndef __BCC__
+
+#include "stdio.h"
+
+#include "stringVector.h"
+#include "stringView.h"
+#include "systemError.h"
+
+#define LINE_READER_DEFAULT_BUF_SIZE (1 << 16)
+
+/**
+ * LineReader reads a FILE in big blocks and hands out each line as a
+ * StringView into its buffer, so lines aren't copied one by one like with
+ * String_fgets(). The only copying happens when a line straddles two blocks:
+ * the partial line is moved to the front of the buffer before the next read.
+ */
+typedef struct LineReader {
+  FILE* file;
+  String buffer;
+
+  // Privates. No touchy!
+  size_t _start;   // Start of the next line in [buffer]
+  size_t _scanned; // Bytes from _start already known to have no newline
+  bool _eof;
+} LineReader;
+
+LineReader* initLineReader(LineReader*, FILE*, size_t bufSize, SystemErrNoMems*);
+void deinitLineReader(LineReader*);
+
+bool LineReader_next(LineReader*, StringView* line, Err*);
+
+void _LineReader_fill(LineReader*, Err*);
+
+#endif
+#endif
@@ -6,6 +6,8 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+#include "allocator.h"
+#include "nodePool.h"
 #include "systemError.h"
 
 typedef struct SingleLinkedNode SingleLinkedNode;
@@ -18,6 +20,8 @@ typedef struct LinkedList {
   void* (*_copyInitializer)(void*, const void*, SystemErr*);
   void (*_deInitializer)(void*);
   size_t _typeSize;
+  NodePool* _pool; // When set, nodes and their data share one pool slot
+  const Allocator* _allocator; // Same, but from an allocator. NULL for malloc()
 } LinkedList;
 
 struct SingleLinkedNode {
@@ -27,12 +31,20 @@ struct SingleLinkedNode {
 
 typedef enum LLErr {
   LL_E_CLEAR,
-  LL_E_NOT_FOUND
+  LL_E_NOT_FOUND,
+  LL_E_INCOMPATIBLE,
+  LL_E_RANGE
 } LLErr;
 
 LinkedList* initLinkedList(LinkedList*, size_t, void* (*)(void*, const void*, SystemErr*),
                            void (*)(void*));
 LinkedList* initLinkedListCp(LinkedList*, const LinkedList*, SystemErr*);
+LinkedList* initLinkedListPooled(LinkedList*, size_t,
+                                 void* (*)(void*, const void*, SystemErr*),
+                                 void (*)(void*), NodePool*);
+LinkedList* initLinkedListWithAllocator(LinkedList*, size_t,
+                                        void* (*)(void*, const void*, SystemErr*),
+                                        void (*)(void*), const Allocator*);
 void deinitLinkedList(LinkedList*);
 
 SingleLinkedNode* initSingleLinkedNode(SingleLinkedNode*, const void*, size_t,
@@ -58,5 +70,7 @@ void LinkedList_removeLast(LinkedList*);
 void* LinkedList_find(LinkedList* list, void* dataToFind,
                       bool (*cmp)(void* dataToFind, void* itemData), LLErr* le);
 
+size_t LinkedList_poolSlotSize(size_t typeSize);
+
 #endif
 #endif
@@ -1,30 +1,62 @@
 #ifndef MALLOC_H
 #define MALLOC_H
 
-#if __BCC__
 #include "types.h"
 
+#ifndef __BCC__
+  #include "stdlib.h"
+#endif
+
+#ifndef MALLOC_BUF_SIZE
 #define MALLOC_BUF_SIZE 2000
+#endif
 
+// Define MALLOC_TRACE to print every allocation, reallocation and free
+// #define MALLOC_TRACE
+
+#define MALLOC_SIZE_CLASSES 16
+
+/**
+ * MemBuf is the allocator BCC builds use in place of the C library's, handing
+ * out blocks of one static buffer of MALLOC_BUF_SIZE bytes. It builds
+ * everywhere so it can be tested and benchmarked; only BCC builds route
+ * malloc(), realloc() and free() to it.
+ *
+ * Free blocks are kept in segregated lists by power of two size class, with
+ * a bitmap of the non-empty lists, so an allocation looks at no more than
+ * one block of its own class before taking any block of a larger class.
+ * Every block starts with a MemRecord whose size doubles as the boundary
+ * tag, and free blocks also end with a copy of their size, so a freed block
+ * finds and merges with both of its neighbors directly.
+ */
 typedef struct MemRecord {
-  size_t len;
+  size_t size; // Whole block, header included. The low bits are flags.
+
+  // Only while the block is free
   struct MemRecord* next;
+  struct MemRecord* prev;
 } MemRecord;
 
+void initMemBuf();
 
+void* MemBuf_malloc(size_t size);
+void* MemBuf_realloc(void* old, size_t size);
+void MemBuf_free(void* ptr);
+size_t MemBuf_available();
+
+#if __BCC__
 void* malloc(size_t size);
 void* realloc(void* old, size_t size);
 void free(void* ptr);
-
-void initMemRecord();
-void initMemRecordRoot();
-bool MemRecord_isSpaceAvailableAfter();
-MemRecord* MemRecord_allocateAfter();
-MemRecord* MemRecord_findPreviousRecordFor();
-MemRecord* MemRecord_deallocateAfter();
-
-#else
-  #include "stdlib.h"
 #endif
 
+size_t _MemBuf_classOf(size_t size);
+MemRecord* _MemBuf_findFree(size_t size);
+void _MemBuf_link(MemRecord* m);
+void _MemBuf_unlink(MemRecord* m);
+MemRecord* _MemBuf_nextRecord(MemRecord* m);
+bool _MemBuf_resizeInPlace(MemRecord* m, size_t size);
+void _MemBuf_setFree(MemRecord* m, size_t size);
+void _MemBuf_split(MemRecord* m, size_t size);
+
 #endif
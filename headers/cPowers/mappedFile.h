@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#ifndef __BCC__
+
+#include "stringView.h"
+#include "systemError.h"
+#include "vector.h"
+
+typedef enum MappedFileAdvice {
+  MF_ADVICE_NORMAL,
+  MF_ADVICE_SEQUENTIAL,
+  MF_ADVICE_RANDOM,
+  MF_ADVICE_WILLNEED
+} MappedFileAdvice;
+
+/**
+ * MappedFile maps a whole file into memory read only. [bytes] is a byte
+ * Vector over the mapping so the usual read only Vector and String functions
+ * work on it without the file ever being copied into the heap. [bytes] must
+ * never be grown, cleared or deinitialized, and unlike other Vectors it has
+ * no trailing NUL.
+ */
+typedef struct MappedFile {
+  Vector bytes;
+} MappedFile;
+
+typedef Err MappedFileErr;
+
+MappedFile* initMappedFile(MappedFile*, const char* path, MappedFileErr*);
+void deinitMappedFile(MappedFile*);
+
+void MappedFile_advise(MappedFile*, MappedFileAdvice, MappedFileErr*);
+StringView* MappedFile_view(const MappedFile*, StringView*);
+
+#endif
+#endif
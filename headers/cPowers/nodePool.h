@@ -0,0 +1,39 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "systemError.h"
+
+#define NODE_POOL_ALIGN (2 * sizeof(void*))
+#define NODE_POOL_DEFAULT_SLOTS_PER_CHUNK 64
+
+/**
+ * NodePool is a slab allocator for equally sized slots, like linked list
+ * nodes. Slots are carved out of big chunks so handing one out is a pointer
+ * bump or a pop off the free list. Freed slots are only reused, the chunks
+ * aren't given back until the pool is deinitialized. A pool can be shared by
+ * any number of lists with the same slot size.
+ */
+typedef struct NodePool {
+  size_t slotSize;
+  size_t slotsPerChunk;
+
+  // Privates. No touchy!
+  void* _freeSlots; // Linked through the first word of each free slot
+  void* _chunks;    // Linked through the first word of each chunk
+  char* _bump;      // Next never used slot of the newest chunk
+  char* _bumpEnd;
+} NodePool;
+
+NodePool* initNodePool(NodePool*, size_t slotSize, size_t slotsPerChunk);
+void deinitNodePool(NodePool*);
+
+void* NodePool_alloc(NodePool*, SystemErr*);
+void NodePool_free(NodePool*, void* slot);
+
+#endif
+#endif
@@ -0,0 +1,76 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "atomics.h"
+#include "systemError.h"
+#include "vector.h"
+
+/**
+ * Bounded lock-free queues over a preallocated Vector of [capacity] elements
+ * of _typeSize bytes. The capacity is rounded up to a power of two. Elements
+ * are copied in and out bitwise, so whatever they own moves with them and
+ * anything left in the ring when it's deinitialized is simply dropped.
+ *
+ * SpscRingBuffer is for exactly one producer thread and one consumer thread.
+ * Each side only ever writes its own index, so a push or pop is a copy plus
+ * one release store.
+ */
+typedef struct SpscRingBuffer {
+  size_t capacity;
+
+  // Privates. No touchy!
+  Vector _buffer;
+  size_t _mask;
+  char _pad0[CP_CACHE_LINE];
+  CP_ATOMIC(size_t) _head; // Next slot to pop, only written by the consumer
+  size_t _tailCache;       // The consumer's last look at _tail
+  char _pad1[CP_CACHE_LINE];
+  CP_ATOMIC(size_t) _tail; // Next slot to push, only written by the producer
+  size_t _headCache;       // The producer's last look at _head
+  char _pad2[CP_CACHE_LINE];
+} SpscRingBuffer;
+
+/**
+ * MpmcRingBuffer takes any number of producers and consumers. Every slot has
+ * a sequence number telling which lap of the ring it's ready for, so threads
+ * only contend on claiming a position and never wait on each other's copies.
+ */
+typedef struct MpmcRingBuffer {
+  size_t capacity;
+
+  // Privates. No touchy!
+  Vector _buffer;
+  Vector _sequences; // One atomic size_t per slot
+  size_t _mask;
+  char _pad0[CP_CACHE_LINE];
+  CP_ATOMIC(size_t) _head;
+  char _pad1[CP_CACHE_LINE];
+  CP_ATOMIC(size_t) _tail;
+  char _pad2[CP_CACHE_LINE];
+} MpmcRingBuffer;
+
+SpscRingBuffer* initSpscRingBuffer(SpscRingBuffer*, size_t typeSize,
+                                   size_t capacity, SystemErrNoMems*);
+void deinitSpscRingBuffer(SpscRingBuffer*);
+
+bool SpscRingBuffer_push(SpscRingBuffer*, const void* data);
+bool SpscRingBuffer_pop(SpscRingBuffer*, void* out);
+size_t SpscRingBuffer_size(SpscRingBuffer*);
+
+MpmcRingBuffer* initMpmcRingBuffer(MpmcRingBuffer*, size_t typeSize,
+                                   size_t capacity, SystemErrNoMems*);
+void deinitMpmcRingBuffer(MpmcRingBuffer*);
+
+bool MpmcRingBuffer_push(MpmcRingBuffer*, const void* data);
+bool MpmcRingBuffer_pop(MpmcRingBuffer*, void* out);
+size_t MpmcRingBuffer_size(MpmcRingBuffer*);
+
+size_t _RingBuffer_roundCapacity(size_t capacity);
+
+#endif
+#endif
@@ -0,0 +1,40 @@
+#ifndef SEGMENTED_ARRAY_H
+#define SEGMENTED_ARRAY_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "atomics.h"
+#include "systemError.h"
+
+#define SEGMENTED_ARRAY_SEGMENTS 48
+
+/**
+ * SegmentedArray is an array that grows without ever moving an element.
+ * Storage is a list of segments where each one is twice as long as the one
+ * before it, so an index maps to its segment with a single bit scan. Segments
+ * are allocated on first use and any number of threads may reserve and
+ * access elements at once. Segments are zeroed when they're allocated and
+ * aren't freed until the array is deinitialized.
+ */
+typedef struct SegmentedArray {
+  // Privates. No touchy!
+  size_t _typeSize;
+  size_t _firstShift; // log2 of the length of the first segment
+  CP_ATOMIC(char*) _segments[SEGMENTED_ARRAY_SEGMENTS];
+} SegmentedArray;
+
+SegmentedArray* initSegmentedArray(SegmentedArray*, size_t typeSize,
+                                   size_t firstSegmentLength);
+void deinitSegmentedArray(SegmentedArray*);
+
+void* SegmentedArray_at(SegmentedArray*, size_t index);
+void* SegmentedArray_reserve(SegmentedArray*, size_t index, SystemErrNoMems*);
+
+size_t _SegmentedArray_segmentOf(const SegmentedArray*, size_t index,
+                                 size_t* offset);
+
+#endif
+#endif
@@ -6,22 +6,53 @@
 #endif
 
 #include "systemError.h"
+#include "stringView.h"
 #include "vector.h"
 
 typedef Vector String;
 
+#define STRING_NPOS ((size_t) -1) // Returned by the String_find functions
+
 String* initString(String*, const char*, SystemErrNoMems*);
+String* initStringN(String*, const char*, size_t, SystemErrNoMems*);
 String* initStringCp(String*, const String*, SystemErrNoMems*);
+String* initStringMove(String*, String*);
+String* initStringWithAllocator(String*, const char*, size_t, const Allocator*,
+                                SystemErrNoMems*);
 void deinitString(String*);
 
 void String_catnprintf(String* str, size_t n, SystemErrNoMems* se, const char* fmt, ...);
 char String_charAt(const String*, size_t, VectorErrRange*);
 int String_cmp(const String*, const String*);
+size_t String_count(const String*, char);
+bool String_equals(const String*, const String*);
 void String_fgets(String*, FILE*, SystemErrNoMems*);
+size_t String_find(const String*, const char* needle, size_t start);
+size_t String_findAny(const String*, const char* chars, size_t start);
+size_t String_findChar(const String*, char, size_t start);
 void String_gets();
+#ifndef __BCC__
+u64 String_hash(const String*);
+#endif
 void String_nprintf(String* str, size_t n, SystemErrNoMems* se, const char* fmt, ...);
+void String_split(const String* str, Vector* viewContainer,
+                  const char* delimiters, SystemErrNoMems* se);
 int String_toi(const String* str, int base);
+#ifndef __BCC__
+double String_tod(const String*, StringErrParse*);
+i64 String_toi64(const String*, int base, StringErrParse*);
+u64 String_tou64(const String*, int base, StringErrParse*);
+void String_batchTod(const Vector* strs, Vector* doubles, StringErrParse* pe,
+                     SystemErrNoMems* se);
+void String_batchToi64(const Vector* strs, Vector* ints, int base,
+                       StringErrParse* pe, SystemErrNoMems* se);
+
+void _String_viewAll(const Vector* strs, Vector* views, SystemErrNoMems* se);
+#endif
 void String_tok(const String* str, Vector* tokenContainer,
                 const char* delimiters, SystemErrNoMems* se);
+void String_tokView(const String* str, Vector* viewContainer,
+                    const char* delimiters, SystemErrNoMems* se);
+StringView* String_view(const String*, StringView*);
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef STRING_VIEW_H
+#define STRING_VIEW_H
+
+#include "types.h"
+
+#include "systemError.h"
+#include "vector.h"
+
+/**
+ * StringView is a pointer and a length into characters owned by someone else,
+ * usually a String. It never allocates, isn't NUL terminated, and is only
+ * valid for as long as the characters it points at stay put.
+ */
+typedef struct StringView {
+  const char* data;
+  size_t length;
+} StringView;
+
+/**
+ * Given when text isn't a number or the number doesn't fit.
+ */
+typedef Err StringErrParse;
+
+StringView* initStringView(StringView*, const char*, size_t);
+
+int StringView_cmp(const StringView*, const StringView*);
+bool StringView_equals(const StringView*, const StringView*);
+#ifndef __BCC__
+u64 StringView_hash(const StringView*);
+#endif
+
+bool StringView_popLine(StringView* remaining, StringView* line);
+void StringView_split(const StringView* view, Vector* viewContainer,
+                      const char* delimiters, SystemErrNoMems* se);
+void StringView_tok(const StringView* view, Vector* viewContainer,
+                    const char* delimiters, SystemErrNoMems* se);
+
+#ifndef __BCC__
+double StringView_tod(const StringView*, StringErrParse*);
+i64 StringView_toi64(const StringView*, int base, StringErrParse*);
+u64 StringView_tou64(const StringView*, int base, StringErrParse*);
+
+void StringView_batchTod(const Vector* views, Vector* doubles,
+                         StringErrParse* pe, SystemErrNoMems* se);
+void StringView_batchToi64(const Vector* views, Vector* ints, int base,
+                           StringErrParse* pe, SystemErrNoMems* se);
+#endif
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef TYPED_VECTOR_H
+#define TYPED_VECTOR_H
+
+#ifndef __BCC__
+
+#include <string.h>
+
+#include "systemError.h"
+#include "vector.h"
+
+/**
+ * DEFINE_VECTOR(T, Name) generates Name, a Vector of T whose functions are
+ * static inline and know sizeof(T) at compile time. Elements are copied by
+ * assignment, so loops over ints and doubles can be vectorized instead of
+ * going through memcpy() with a runtime size. Name only wraps a Vector, as
+ * [vector], so every Vector function still works on &name.vector.
+ *
+ * DEFINE_VECTOR_ADVANCED(T, Name, cp, deinit) is the same for elements that
+ * need a copy initializer and deinitializer. They're called directly by the
+ * generated functions, so they can be inlined too, and are also given to
+ * the Vector for the plain Vector functions.
+ *
+ * For DEFINE_VECTOR(int, Ints) that's:
+ *
+ *   Ints* initInts(Ints*, SystemErrNoMems*);
+ *   void deinitInts(Ints*);
+ *   int* Ints_add(Ints*, int item, SystemErrNoMems*);
+ *   Ints* Ints_cat(Ints*, const int* items, size_t num, SystemErrNoMems*);
+ *   void Ints_clear(Ints*);
+ *   int* Ints_data(const Ints*);
+ *   Ints* Ints_fill(Ints*, int item, size_t num, SystemErrNoMems*);
+ *   int* Ints_get(const Ints*, size_t index); // Unchecked
+ *   void Ints_removeLast(Ints*);
+ *
+ * Ints and Doubles are already defined below.
+ */
+#define DEFINE_VECTOR(T, Name) \
+  _DEFINE_VECTOR(T, Name, _TYPED_VECTOR_ASSIGN, _TYPED_VECTOR_NO_DEINIT, \
+                 NULL, NULL, 0)
+
+#define DEFINE_VECTOR_ADVANCED(T, Name, cp, deinit) \
+  _DEFINE_VECTOR(T, Name, cp, deinit, cp, deinit, 1)
+
+#define _TYPED_VECTOR_ASSIGN(to, from, se) (*(to) = *(from))
+#define _TYPED_VECTOR_NO_DEINIT(el) ((void) (el))
+
+// [cpFn] and [deinitFn] are called by the generated code, [vectorCp] and
+// [vectorDeinit] are stored in the Vector. [hasCp] is a constant so the
+// compiler drops whichever branch doesn't apply.
+#define _DEFINE_VECTOR(T, Name, cpFn, deinitFn, vectorCp, vectorDeinit, hasCp) \
+typedef struct Name { \
+  Vector vector; \
+} Name; \
+\
+static inline Name* init##Name(Name* tv, SystemErrNoMems* se) { \
+  initVector(&tv->vector, sizeof(T), \
+             (void* (*)(void*, const void*, Err*)) vectorCp, \
+             (void (*)(void*)) vectorDeinit, se); \
+  return tv; \
+} \
+\
+static inline T* Name##_data(const Name* tv) { \
+  return (T*) tv->vector.arr; \
+} \
+\
+static inline T* Name##_get(const Name* tv, size_t index) { \
+  return (T*) tv->vector.arr + index; \
+} \
+\
+static inline void Name##_clear(Name* tv) { \
+  T* el; \
+  T* end = Name##_data(tv) + tv->vector.length; \
+  for (el = Name##_data(tv); el < end; ++el) { \
+    deinitFn(el); \
+  } \
+  tv->vector.length = 0; \
+  memset(Name##_data(tv), 0, sizeof(T)); \
+} \
+\
+static inline void deinit##Name(Name* tv) { \
+  if (tv->vector.arr) { \
+    Name##_clear(tv); \
+  } \
+  deinitVector(&tv->vector); \
+} \
+\
+static inline T* Name##_add(Name* tv, T item, SystemErrNoMems* se) { \
+  Vector* v = &tv->vector; \
+  T* to; \
+  if (v->_arrSize <= v->length + 1) { \
+    _Vector_resize(v, 1, se); \
+    if (se->any) { \
+      return NULL; \
+    } \
+  } \
+  to = Name##_data(tv) + v->length; \
+  cpFn(to, &item, se); /* The null element was already zeroed */ \
+  ++v->length; \
+  memset(to + 1, 0, sizeof(T)); \
+  return to; \
+} \
+\
+static inline Name* Name##_cat(Name* tv, const T* items, size_t num, \
+                               SystemErrNoMems* se) { \
+  Vector* v = &tv->vector; \
+  T* to; \
+  size_t i; \
+  if (v->_arrSize <= v->length + num) { \
+    _Vector_resize(v, num, se); \
+    if (se->any) { \
+      return tv; \
+    } \
+  } \
+  to = Name##_data(tv) + v->length; \
+  if (hasCp) { \
+    for (i = 0; i < num && !se->any; ++i) { \
+      memset(to + i, 0, sizeof(T)); \
+      cpFn(to + i, items + i, se); \
+    } \
+    num = i; \
+  } else { \
+    for (i = 0; i < num; ++i) { \
+      cpFn(to + i, items + i, se); \
+    } \
+  } \
+  v->length += num; \
+  memset(to + num, 0, sizeof(T)); \
+  return tv; \
+} \
+\
+static inline Name* Name##_fill(Name* tv, T item, size_t num, \
+                                SystemErrNoMems* se) { \
+  Vector* v = &tv->vector; \
+  T* to; \
+  size_t i; \
+  if (v->_arrSize <= v->length + num) { \
+    _Vector_resize(v, num, se); \
+    if (se->any) { \
+      return tv; \
+    } \
+  } \
+  to = Name##_data(tv) + v->length; \
+  if (hasCp) { \
+    for (i = 0; i < num && !se->any; ++i) { \
+      memset(to + i, 0, sizeof(T)); \
+      cpFn(to + i, &item, se); \
+    } \
+    num = i; \
+  } else { \
+    for (i = 0; i < num; ++i) { \
+      cpFn(to + i, &item, se); \
+    } \
+  } \
+  v->length += num; \
+  memset(to + num, 0, sizeof(T)); \
+  return tv; \
+} \
+\
+static inline void Name##_removeLast(Name* tv) { \
+  T* last; \
+  if (tv->vector.length) { \
+    last = Name##_data(tv) + --tv->vector.length; \
+    deinitFn(last); \
+    memset(last, 0, sizeof(T)); \
+  } \
+}
+
+DEFINE_VECTOR(int, Ints)
+DEFINE_VECTOR(double, Doubles)
+
+#endif
+#endif
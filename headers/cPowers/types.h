@@ -25,6 +25,8 @@ typedef enum {
 #include "stdbool.h"
 
 typedef unsigned int     u32;
+typedef unsigned long long u64;
+typedef long long        i64;
 
 #endif
 
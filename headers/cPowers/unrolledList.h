@@ -0,0 +1,75 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#ifndef __BCC__
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "linkedList.h"
+#include "systemError.h"
+
+#define UNROLLED_LIST_DEFAULT_CHUNK_SIZE 4096
+
+typedef struct UnrolledChunk UnrolledChunk;
+
+/**
+ * UnrolledList is a linked list of chunks, each holding a run of elements
+ * back to back. Appending and prepending are O(1), inserting in the middle
+ * only shifts elements within one chunk, and walking the list streams
+ * through memory nearly as fast as an array. Element addresses change when
+ * elements are inserted or removed around them.
+ */
+typedef struct UnrolledList {
+  UnrolledChunk* firstChunk;
+  UnrolledChunk* lastChunk;
+  size_t length;
+
+  void* (*_copyInitializer)(void*, const void*, SystemErr*);
+  void (*_deInitializer)(void*);
+  size_t _typeSize;
+  size_t _chunkCapacity; // Elements per chunk
+} UnrolledList;
+
+struct UnrolledChunk {
+  UnrolledChunk* prev;
+  UnrolledChunk* next;
+  size_t start; // Elements live in [start, start + count)
+  size_t count;
+  union {
+    long double ld;
+    long long ll;
+    void* p;
+  } data[];
+};
+
+UnrolledList* initUnrolledList(UnrolledList*, size_t,
+                               void* (*)(void*, const void*, SystemErr*),
+                               void (*)(void*));
+UnrolledList* initUnrolledListAdvanced(UnrolledList*, size_t, size_t chunkSize,
+                                       void* (*)(void*, const void*, SystemErr*),
+                                       void (*)(void*));
+void deinitUnrolledList(UnrolledList*);
+
+void UnrolledList_append(UnrolledList*, const void* data, SystemErr*);
+void* UnrolledList_appendEmpty(UnrolledList*, SystemErr*);
+void UnrolledList_prepend(UnrolledList*, const void* data, SystemErr*);
+void UnrolledList_insertAt(UnrolledList*, size_t index, const void* data,
+                           SystemErr*, LLErr*);
+
+void* UnrolledList_at(const UnrolledList*, size_t index, LLErr*);
+void* UnrolledList_first(const UnrolledList*);
+void* UnrolledList_last(const UnrolledList*);
+void UnrolledList_clear(UnrolledList*);
+
+void UnrolledList_removeAt(UnrolledList*, size_t index, LLErr*);
+void UnrolledList_removeFirst(UnrolledList*);
+void UnrolledList_removeLast(UnrolledList*);
+
+void* UnrolledList_find(UnrolledList* list, void* dataToFind,
+                        bool (*cmp)(void* dataToFind, void* itemData), LLErr* le);
+void UnrolledList_forEach(UnrolledList*, void (*fn)(void* item, void* context),
+                          void* context);
+
+#endif
+#endif
@@ -5,6 +5,7 @@
 
 #include "systemError.h"
 
+#include "allocator.h"
 #include "malloc.h"
 
 #define _VECTOR_DEFAULT_INIT_SIZE 16
@@ -16,6 +17,28 @@
  * hold any data type as long as the type size is given.
  */
 
+/**
+ * Controls how a Vector grows when it runs out of room. The new capacity is
+ * the old one scaled by [factorNum] / [factorDen] (3 / 2 gives 1.5x), but
+ * never less than what's needed. [maxStep] caps the number of elements a
+ * single growth may add, 0 for no cap. Allocations of at least
+ * [alignThreshold] bytes are rounded up to a multiple of [alignBytes] so very
+ * large buffers can be backed by huge pages, 0 disables it.
+ */
+typedef struct VectorGrowthPolicy {
+  size_t factorNum;
+  size_t factorDen;
+  size_t maxStep;
+  size_t alignBytes;
+  size_t alignThreshold;
+} VectorGrowthPolicy;
+
+extern const VectorGrowthPolicy VECTOR_GROWTH_DOUBLE;
+extern const VectorGrowthPolicy VECTOR_GROWTH_1_5X;
+#ifndef __BCC__
+extern const VectorGrowthPolicy VECTOR_GROWTH_HUGE_PAGES;
+#endif
+
 // Look, a mutherfuckin vector. Let's reinvent the rock
 typedef struct Vector  {
   void* arr;
@@ -26,6 +49,11 @@ typedef struct Vector  {
   void* (*_copyInitializer)(void*, const void*, Err*);
   void (*_deInitializer)(void*);
   size_t _typeSize;
+  // Optional batched form of _copyInitializer. Copies [num] elements per call.
+  void* (*_rangeCopyInitializer)(void*, const void*, size_t, Err*);
+  const VectorGrowthPolicy* _growthPolicy; // NULL for the default doubling
+  const Allocator* _allocator; // NULL for malloc() and friends
+  u8 _allocKind; // What AllocStats counts the array as, an AllocKind
 } Vector;
 
 /**
@@ -35,13 +63,43 @@ typedef Err VectorErrIncompatibleTypes;
 typedef Err VectorErrRange;
 typedef Err VectorErrEmpty;
 
+/**
+ * Vector_get() is Vector_at() without the range check, for loops that already
+ * know [index] is below the length. VECTOR_GET() is the same for a Vector of
+ * [type], where the element size is a constant so indexing is a single
+ * instruction, and it can be assigned to. VECTOR_FOR_EACH() points [el], a
+ * [type]*, at each element in turn:
+ *
+ *   int* el;
+ *   VECTOR_FOR_EACH(int, el, &v) {
+ *     sum += *el;
+ *   }
+ */
+#if __BCC__
+#define Vector_get(v, index) \
+  ((void*) ((char*) (v)->arr + (index) * (v)->_typeSize))
+#else
+static inline void* Vector_get(const Vector* v, size_t index) {
+  return (char*) v->arr + index * v->_typeSize;
+}
+#endif
+
+#define VECTOR_GET(type, v, index) (((type*) (v)->arr)[index])
+#define VECTOR_FOR_EACH(type, el, v) \
+  for ((el) = (type*) (v)->arr; (el) < (type*) (v)->arr + (v)->length; ++(el))
+
 
 Vector* initVector(Vector*, size_t, void* (*)(void*, const void*, Err*),
                    void (*)(void*), SystemErrNoMems*);
 Vector* initVectorCp(Vector*, const Vector*, SystemErrNoMems*);
+Vector* initVectorMove(Vector*, Vector*);
 Vector* initVectorAdvanced(Vector*, size_t, size_t, const void*, size_t,
                            void* (*)(void*, const void*, Err*), void (*)(void*),
                            SystemErrNoMems*);
+Vector* initVectorWithAllocator(Vector*, size_t, size_t, const void*, size_t,
+                                void* (*)(void*, const void*, Err*),
+                                void (*)(void*), const Allocator*,
+                                SystemErrNoMems*);
 void deinitVector(Vector*);
 
 
@@ -54,17 +112,37 @@ Vector* initDoubleVector(Vector* v, const char* contents, size_t num,
 
 void* Vector_add(Vector*, const void*, SystemErrNoMems*);
 void* Vector_addEmpty(Vector* v, SystemErrNoMems* se);
+void* Vector_addMove(Vector*, void*, SystemErrNoMems*);
 void* Vector_at(const Vector*, size_t, VectorErrRange* e);
 Vector* Vector_cat(Vector*, const Vector*, VectorErrIncompatibleTypes*, SystemErrNoMems*);
 Vector* Vector_catPrimitive(Vector*, const void*, size_t, SystemErrNoMems*);
 Vector* Vector_clear(Vector*);
+void Vector_forEach(Vector*, void (*)(void* item, void* context), void*);
+Vector* Vector_map(const Vector*, Vector*,
+                   void (*)(void* to, const void* from, void* context), void*,
+                   SystemErrNoMems*);
+void* Vector_reduce(const Vector*, void* accumulator,
+                    void (*)(void* accumulator, const void* item, void* context),
+                    void*);
+void Vector_reserve(Vector*, size_t, SystemErrNoMems*);
+void Vector_shrinkToFit(Vector*, SystemErrNoMems*);
 void Vector_reverse(const Vector*, Vector*, SystemErrNoMems*);
 void* Vector_last(Vector*, VectorErrEmpty*);
 void Vector_removeLast(Vector*);
-
+void Vector_setRangeCopyInitializer(Vector*,
+                                    void* (*)(void*, const void*, size_t, Err*));
+void Vector_setGrowthPolicy(Vector*, const VectorGrowthPolicy*);
+void Vector_swap(Vector*, Vector*);
+
+Vector* _Vector_initOfKind(Vector*, size_t, size_t, const void*, size_t,
+                           void* (*)(void*, const void*, Err*),
+                           void (*)(void*), const Allocator*, u8,
+                           SystemErrNoMems*);
 void* _Vector_calcDanglingPtr(const Vector*);
 void _Vector_resize(Vector*, size_t, SystemErrNoMems*);
+void _Vector_setArrSize(Vector*, size_t, SystemErrNoMems*);
 void* _Vector_appendCopy(Vector*, const void*, Err*);
+void _Vector_appendCopies(Vector*, const void*, size_t, Err*);
 void _Vector_appendNull(const Vector*);
 void* _Vector_calcPtrAt(const Vector*, size_t);
 void _Vector_reinit(Vector*, size_t, size_t*, Err*);
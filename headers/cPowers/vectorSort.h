@@ -0,0 +1,46 @@
+#ifndef VECTOR_SORT_H
+#define VECTOR_SORT_H
+
+#include "types.h"
+
+#include "systemError.h"
+#include "stringVector.h"
+#include "vector.h"
+
+/**
+ * Sorting for Vectors. Comparators work like the ones for qsort(), they're
+ * given pointers to two elements and return < 0, 0 or > 0. Elements are moved
+ * bitwise, so the copy initializer is never called.
+ */
+
+// Ranges this short are insertion sorted
+#define _VECTOR_SORT_SMALL 16
+// Enough for the 2 * log2(n) partitions allowed before falling back to heapsort
+#define _VECTOR_SORT_MAX_DEPTH 128
+#define _VECTOR_SORT_PARALLEL_CUTOFF 8192
+
+void Vector_sort(Vector*, int (*)(const void*, const void*));
+void Vector_stableSort(Vector*, int (*)(const void*, const void*),
+                       SystemErrNoMems*);
+void Vector_sortStrings(Vector*);
+#ifndef __BCC__
+void Vector_sortInts(Vector*, SystemErrNoMems*);
+void Vector_sortDoubles(Vector*, SystemErrNoMems*);
+void Vector_parallelSort(Vector*, int (*)(const void*, const void*), uint,
+                         SystemErrNoMems*);
+#endif
+
+uint _VectorSort_depthLimit(size_t);
+void _VectorSort_intro(char*, size_t, size_t, int (*)(const void*, const void*),
+                       uint);
+size_t _VectorSort_partition(char*, size_t, size_t,
+                             int (*)(const void*, const void*));
+void _VectorSort_heap(char*, size_t, size_t, int (*)(const void*, const void*));
+void _VectorSort_insertion(char*, size_t, size_t,
+                           int (*)(const void*, const void*));
+void _VectorSort_merge(const char*, size_t, size_t, size_t, char*, size_t,
+                       int (*)(const void*, const void*));
+void _VectorSort_multikey(String*, size_t, size_t);
+void _VectorSort_swap(char*, char*, size_t);
+
+#endif
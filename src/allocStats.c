@@ -0,0 +1,241 @@
+#include "allocStats.h"
+
+#include "string.h"
+
+#if __BCC__
+typedef ulong _AllocCounter;
+#define _ALLOC_LOAD(c) (c)
+#define _ALLOC_STORE(c, n) ((c) = (n))
+#define _ALLOC_ADD(c, n) ((c) += (n))
+#else
+#include "atomics.h"
+// Relaxed is enough, nothing else is ordered by the counters
+typedef CP_ATOMIC(ulong) _AllocCounter;
+#define _ALLOC_LOAD(c) atomic_load_explicit(&(c), memory_order_relaxed)
+#define _ALLOC_STORE(c, n) atomic_store_explicit(&(c), (n), memory_order_relaxed)
+#define _ALLOC_ADD(c, n) \
+  ((void) atomic_fetch_add_explicit(&(c), (n), memory_order_relaxed))
+#endif
+
+typedef struct _AllocCounters {
+  _AllocCounter allocs;
+  _AllocCounter reallocs;
+  _AllocCounter frees;
+  _AllocCounter bytesRequested;
+  _AllocCounter bytesInUse;
+  _AllocCounter peakBytesInUse;
+  _AllocCounter reallocCopyBytes;
+  _AllocCounter sizeHistogram[ALLOC_STATS_BUCKETS];
+} _AllocCounters;
+
+static _AllocCounter enabled;
+static _AllocCounters counters[ALLOC_KINDS];
+
+static const char* kindNames[ALLOC_KINDS] = {
+  "other", "vector", "string", "linkedList", "hashMap"
+};
+
+void _AllocStats_grow(_AllocCounters* c, size_t size);
+void _AllocStats_shrink(_AllocCounters* c, size_t size);
+void _AllocStats_catCounter(String* str, const char* name, ulong value,
+                            SystemErrNoMems* se);
+
+
+/**
+ * Starts or stops counting. The counters keep their values either way.
+ */
+void AllocStats_setEnabled(bool on) {
+  _ALLOC_STORE(enabled, on ? 1 : 0);
+}
+
+bool AllocStats_enabled() {
+  return _ALLOC_LOAD(enabled) != 0;
+}
+
+/**
+ * Zeroes every counter. Blocks that are still around when this is called
+ * are forgotten, so bytesInUse counts only what was allocated since.
+ */
+void AllocStats_reset() {
+  int kind;
+  int i;
+  for (kind = 0; kind < ALLOC_KINDS; ++kind) {
+    _AllocCounters* c = counters + kind;
+    _ALLOC_STORE(c->allocs, 0);
+    _ALLOC_STORE(c->reallocs, 0);
+    _ALLOC_STORE(c->frees, 0);
+    _ALLOC_STORE(c->bytesRequested, 0);
+    _ALLOC_STORE(c->bytesInUse, 0);
+    _ALLOC_STORE(c->peakBytesInUse, 0);
+    _ALLOC_STORE(c->reallocCopyBytes, 0);
+    for (i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+      _ALLOC_STORE(c->sizeHistogram[i], 0);
+    }
+  }
+}
+
+/**
+ * Copies the counters of [kind] into [stats].
+ * @return  [stats]
+ */
+AllocStats* AllocStats_get(AllocKind kind, AllocStats* stats) {
+  _AllocCounters* c = counters + kind;
+  int i;
+  stats->allocs = _ALLOC_LOAD(c->allocs);
+  stats->reallocs = _ALLOC_LOAD(c->reallocs);
+  stats->frees = _ALLOC_LOAD(c->frees);
+  stats->bytesRequested = _ALLOC_LOAD(c->bytesRequested);
+  stats->bytesInUse = _ALLOC_LOAD(c->bytesInUse);
+  stats->peakBytesInUse = _ALLOC_LOAD(c->peakBytesInUse);
+  stats->reallocCopyBytes = _ALLOC_LOAD(c->reallocCopyBytes);
+  for (i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+    stats->sizeHistogram[i] = _ALLOC_LOAD(c->sizeHistogram[i]);
+  }
+
+  return stats;
+}
+
+const char* AllocStats_kindName(AllocKind kind) {
+  return kindNames[kind];
+}
+
+/**
+ * Appends every kind's counters to [str] as a JSON object keyed by
+ * AllocStats_kindName(). Histograms are arrays of ALLOC_STATS_BUCKETS counts.
+ * @error  S_E_NOMEMS
+ */
+void AllocStats_toJson(String* str, SystemErrNoMems* se) {
+  AllocStats stats;
+  char num[24];
+  int kind;
+  int i;
+  Vector_catPrimitive(str, "{", 1, se);
+  for (kind = 0; kind < ALLOC_KINDS && !se->any; ++kind) {
+    AllocStats_get((AllocKind) kind, &stats);
+    if (kind) {
+      Vector_catPrimitive(str, ", ", 2, se);
+    }
+    Vector_catPrimitive(str, "\"", 1, se);
+    Vector_catPrimitive(str, kindNames[kind], strlen(kindNames[kind]), se);
+    Vector_catPrimitive(str, "\": {", 4, se);
+    _AllocStats_catCounter(str, "allocs", stats.allocs, se);
+    _AllocStats_catCounter(str, "reallocs", stats.reallocs, se);
+    _AllocStats_catCounter(str, "frees", stats.frees, se);
+    _AllocStats_catCounter(str, "bytesRequested", stats.bytesRequested, se);
+    _AllocStats_catCounter(str, "bytesInUse", stats.bytesInUse, se);
+    _AllocStats_catCounter(str, "peakBytesInUse", stats.peakBytesInUse, se);
+    _AllocStats_catCounter(str, "reallocCopyBytes", stats.reallocCopyBytes, se);
+    Vector_catPrimitive(str, "\"sizeHistogram\": [", 18, se);
+    for (i = 0; i < ALLOC_STATS_BUCKETS; ++i) {
+      sprintf(num, i ? ", %lu" : "%lu", stats.sizeHistogram[i]);
+      Vector_catPrimitive(str, num, strlen(num), se);
+    }
+    Vector_catPrimitive(str, "]}", 2, se);
+  }
+  Vector_catPrimitive(str, "}", 1, se);
+}
+
+/**
+ * A new block of [size] bytes.
+ */
+void AllocStats_recordAlloc(AllocKind kind, size_t size) {
+  _AllocCounters* c = counters + kind;
+  if (AllocStats_enabled()) {
+    _ALLOC_ADD(c->allocs, 1);
+    _ALLOC_ADD(c->bytesRequested, size);
+    _ALLOC_ADD(c->sizeHistogram[_AllocStats_bucketOf(size)], 1);
+    _AllocStats_grow(c, size);
+  }
+}
+
+/**
+ * A block went from [oldSize] to [size] bytes. When it [moved] the old
+ * contents were copied over, which is what reallocCopyBytes keeps track of.
+ */
+void AllocStats_recordResize(AllocKind kind, size_t oldSize, size_t size,
+                             bool moved) {
+  _AllocCounters* c = counters + kind;
+  if (AllocStats_enabled()) {
+    _ALLOC_ADD(c->reallocs, 1);
+    _ALLOC_ADD(c->bytesRequested, size);
+    _ALLOC_ADD(c->sizeHistogram[_AllocStats_bucketOf(size)], 1);
+    if (moved) {
+      _ALLOC_ADD(c->reallocCopyBytes, oldSize < size ? oldSize : size);
+    }
+
+    if (size > oldSize) {
+      _AllocStats_grow(c, size - oldSize);
+    } else {
+      _AllocStats_shrink(c, oldSize - size);
+    }
+  }
+}
+
+/**
+ * A block of [size] bytes is gone.
+ */
+void AllocStats_recordRelease(AllocKind kind, size_t size) {
+  _AllocCounters* c = counters + kind;
+  if (AllocStats_enabled()) {
+    _ALLOC_ADD(c->frees, 1);
+    _AllocStats_shrink(c, size);
+  }
+}
+
+
+/**
+ * @return  floor(log2([size])), clamped to the histogram. 0 goes with 1.
+ */
+uint _AllocStats_bucketOf(size_t size) {
+  uint bucket = 0;
+  while (size > 1 && bucket < ALLOC_STATS_BUCKETS - 1) {
+    size >>= 1;
+    ++bucket;
+  }
+
+  return bucket;
+}
+
+void _AllocStats_grow(_AllocCounters* c, size_t size) {
+#if __BCC__
+  c->bytesInUse += size;
+  if (c->bytesInUse > c->peakBytesInUse) {
+    c->peakBytesInUse = c->bytesInUse;
+  }
+#else
+  ulong inUse = atomic_fetch_add_explicit(&c->bytesInUse, size,
+                                          memory_order_relaxed) + size;
+  ulong peak = _ALLOC_LOAD(c->peakBytesInUse);
+  while (inUse > peak &&
+         !atomic_compare_exchange_weak_explicit(&c->peakBytesInUse, &peak, inUse,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+#endif
+}
+
+/**
+ * Blocks from before counting was enabled or the last reset were never
+ * added, so bytesInUse stops at 0 instead of wrapping around.
+ */
+void _AllocStats_shrink(_AllocCounters* c, size_t size) {
+#if __BCC__
+  c->bytesInUse = c->bytesInUse > size ? c->bytesInUse - size : 0;
+#else
+  ulong inUse = _ALLOC_LOAD(c->bytesInUse);
+  while (!atomic_compare_exchange_weak_explicit(&c->bytesInUse, &inUse,
+                                                inUse > size ? inUse - size : 0,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+#endif
+}
+
+void _AllocStats_catCounter(String* str, const char* name, ulong value,
+                            SystemErrNoMems* se) {
+  char num[24];
+  Vector_catPrimitive(str, "\"", 1, se);
+  Vector_catPrimitive(str, name, strlen(name), se);
+  sprintf(num, "\": %lu, ", value);
+  Vector_catPrimitive(str, num, strlen(num), se);
+}
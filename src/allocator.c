@@ -0,0 +1,53 @@
+#include "allocator.h"
+
+void* _Allocator_globalAlloc(void* context, size_t size);
+void* _Allocator_globalResize(void* context, void* ptr, size_t oldSize,
+                              size_t size);
+void _Allocator_globalRelease(void* context, void* ptr, size_t size);
+
+const Allocator ALLOCATOR_GLOBAL = {
+  _Allocator_globalAlloc, _Allocator_globalResize, _Allocator_globalRelease, NULL
+};
+
+/**
+ * The global allocator is called directly rather than through
+ * ALLOCATOR_GLOBAL, so containers without an allocator pay nothing extra.
+ */
+void* Allocator_alloc(const Allocator* a, size_t size) {
+  return a ? a->alloc(a->context, size) : malloc(size);
+}
+
+/**
+ * Like realloc(), a NULL [ptr] allocates a new block.
+ */
+void* Allocator_resize(const Allocator* a, void* ptr, size_t oldSize,
+                       size_t size) {
+  return a ? a->resize(a->context, ptr, oldSize, size) : realloc(ptr, size);
+}
+
+void Allocator_release(const Allocator* a, void* ptr, size_t size) {
+  if (a) {
+    a->release(a->context, ptr, size);
+  } else {
+    free(ptr);
+  }
+}
+
+
+void* _Allocator_globalAlloc(void* context, size_t size) {
+  (void) context;
+  return malloc(size);
+}
+
+void* _Allocator_globalResize(void* context, void* ptr, size_t oldSize,
+                              size_t size) {
+  (void) context;
+  (void) oldSize;
+  return realloc(ptr, size);
+}
+
+void _Allocator_globalRelease(void* context, void* ptr, size_t size) {
+  (void) context;
+  (void) size;
+  free(ptr);
+}
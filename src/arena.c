@@ -0,0 +1,208 @@
+#include "arena.h"
+
+#ifndef __BCC__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * [chunkSize] is how much is allocated at a time, 0 for
+ * ARENA_DEFAULT_CHUNK_SIZE. Nothing is allocated until it's needed.
+ */
+Arena* initArena(Arena* arena, size_t chunkSize) {
+  arena->allocator.alloc = _Arena_allocatorAlloc;
+  arena->allocator.resize = _Arena_allocatorResize;
+  arena->allocator.release = _Arena_allocatorRelease;
+  arena->allocator.context = arena;
+  arena->chunkSize = chunkSize ? chunkSize : ARENA_DEFAULT_CHUNK_SIZE;
+  arena->_chunk = NULL;
+  arena->_bump = NULL;
+  arena->_end = NULL;
+  arena->_spareChunks = NULL;
+  return arena;
+}
+
+/**
+ * Frees every chunk. Anything still pointing into the arena is left dangling.
+ */
+void deinitArena(Arena* arena) {
+  ArenaChunk* chunk;
+  Arena_reset(arena);
+  while (arena->_spareChunks != NULL) {
+    chunk = arena->_spareChunks;
+    arena->_spareChunks = chunk->prev;
+    free(chunk);
+  }
+}
+
+/**
+ * Gives [size] bytes aligned to ARENA_ALIGN.
+ * @error  S_E_NOMEMS
+ */
+void* Arena_alloc(Arena* arena, size_t size, SystemErrNoMems* se) {
+  void* mems = _Arena_bump(arena, size);
+  if (mems == NULL) {
+    se->any = true;
+    sprintf(se->msg, "Arena alloc: No more memory available");
+  }
+
+  return mems;
+}
+
+ArenaMark* Arena_mark(const Arena* arena, ArenaMark* mark) {
+  mark->chunk = arena->_chunk;
+  mark->bump = arena->_bump;
+  return mark;
+}
+
+/**
+ * Takes back everything allocated since [mark] was made, which must have
+ * been made since the last reset or any earlier rollback.
+ */
+void Arena_rollback(Arena* arena, const ArenaMark* mark) {
+  while (arena->_chunk != mark->chunk) {
+    ArenaChunk* chunk = arena->_chunk;
+    arena->_chunk = chunk->prev;
+    chunk->prev = arena->_spareChunks;
+    arena->_spareChunks = chunk;
+  }
+
+  arena->_bump = mark->bump;
+  arena->_end = arena->_chunk ?
+    (char*) arena->_chunk->data + arena->_chunk->size : NULL;
+}
+
+/**
+ * Takes back everything, keeping the chunks to be reused.
+ */
+void Arena_reset(Arena* arena) {
+  ArenaMark start;
+  start.chunk = NULL;
+  start.bump = NULL;
+  Arena_rollback(arena, &start);
+}
+
+/**
+ * A Vector that's in [arena] along with its array.
+ * @error  S_E_NOMEMS
+ */
+Vector* Arena_newVector(Arena* arena, size_t typeSize,
+                        void* (*cpInitializer)(void*, const void*, Err*),
+                        void (*deInitializer)(void*), SystemErrNoMems* se) {
+  Vector* v = (Vector*) Arena_alloc(arena, sizeof(Vector), se);
+  if (v != NULL) {
+    initVectorWithAllocator(v, typeSize, 0, NULL, 0, cpInitializer,
+                            deInitializer, &arena->allocator, se);
+  }
+
+  return se->any ? NULL : v;
+}
+
+/**
+ * A String that's in [arena] along with its characters.
+ * @error  S_E_NOMEMS
+ */
+String* Arena_newString(Arena* arena, const char* contents, SystemErrNoMems* se) {
+  String* str = (String*) Arena_alloc(arena, sizeof(String), se);
+  if (str != NULL) {
+    initStringWithAllocator(str, contents, contents ? strlen(contents) : 0,
+                            &arena->allocator, se);
+  }
+
+  return se->any ? NULL : str;
+}
+
+
+/**
+ * @return  [size] bytes or NULL when out of memory
+ */
+void* _Arena_bump(Arena* arena, size_t size) {
+  char* mems = arena->_bump;
+  if (mems != NULL) {
+    mems += (ARENA_ALIGN - (size_t) mems % ARENA_ALIGN) % ARENA_ALIGN;
+  }
+
+  if (mems == NULL || mems > arena->_end || (size_t) (arena->_end - mems) < size) {
+    if (!_Arena_newChunk(arena, size)) {
+      return NULL;
+    }
+    mems = arena->_bump;
+  }
+
+  arena->_bump = mems + size;
+  return mems;
+}
+
+/**
+ * Moves on to a chunk with room for [size] bytes, reusing a spare one if
+ * there is one big enough. Allocations bigger than a chunk get a chunk of
+ * their own.
+ */
+bool _Arena_newChunk(Arena* arena, size_t size) {
+  ArenaChunk** spare = &arena->_spareChunks;
+  ArenaChunk* chunk;
+  size_t chunkSize = size > arena->chunkSize ? size : arena->chunkSize;
+  // The header would wrap the malloc() size around to something tiny
+  if (size > SIZE_MAX - offsetof(ArenaChunk, data) - ARENA_ALIGN) {
+    return false;
+  }
+
+  while (*spare != NULL && (*spare)->size < size) {
+    spare = &(*spare)->prev;
+  }
+
+  if (*spare != NULL) {
+    chunk = *spare;
+    *spare = chunk->prev;
+  } else {
+    chunk = (ArenaChunk*) malloc(offsetof(ArenaChunk, data) + chunkSize);
+    if (chunk == NULL) {
+      return false;
+    }
+    chunk->size = chunkSize;
+  }
+
+  chunk->prev = arena->_chunk;
+  arena->_chunk = chunk;
+  arena->_bump = (char*) chunk->data;
+  arena->_end = (char*) chunk->data + chunk->size;
+  return true;
+}
+
+void* _Arena_allocatorAlloc(void* arena, size_t size) {
+  return _Arena_bump((Arena*) arena, size);
+}
+
+/**
+ * The most recent allocation is resized in place when it fits. Anything
+ * else is copied to a new allocation and its old space is only reclaimed by
+ * a reset or rollback.
+ */
+void* _Arena_allocatorResize(void* context, void* ptr, size_t oldSize,
+                             size_t size) {
+  Arena* arena = (Arena*) context;
+  void* mems;
+  if (ptr != NULL && (char*) ptr + oldSize == arena->_bump &&
+      (size_t) (arena->_end - (char*) ptr) >= size) {
+    arena->_bump = (char*) ptr + size;
+    return ptr;
+  }
+
+  mems = _Arena_bump(arena, size);
+  if (mems != NULL && ptr != NULL) {
+    memcpy(mems, ptr, oldSize < size ? oldSize : size);
+  }
+
+  return mems;
+}
+
+void _Arena_allocatorRelease(void* context, void* ptr, size_t size) {
+  Arena* arena = (Arena*) context;
+  if (ptr != NULL && (char*) ptr + size == arena->_bump) {
+    arena->_bump = (char*) ptr;
+  }
+}
+
+#endif
@@ -0,0 +1,280 @@
+#include "byteScan.h"
+
+#include "string.h"
+
+#if !defined(__BCC__) && defined(__GNUC__) && defined(__x86_64__)
+#define _BYTE_SCAN_X86 1
+#include <immintrin.h>
+
+#define _BYTE_SCAN_AVX2 __attribute__((target("avx2,popcnt")))
+
+static bool _ByteScan_hasAvx2() {
+  return __builtin_cpu_supports("avx2");
+}
+#endif
+
+static size_t _ByteScan_countScalar(const char* s, size_t len, char c);
+static size_t _ByteScan_findScalar(const char* s, size_t len, const char* needle,
+                                   size_t needleLen);
+static size_t _ByteScan_findAnyScalar(const char* s, size_t len,
+                                      const ByteSet* set);
+
+
+/**
+ * Prepares [set] to match any of the characters in the NUL terminated
+ * [chars].
+ */
+ByteSet* initByteSet(ByteSet* set, const char* chars) {
+  memset(set->contains, false, sizeof(set->contains));
+  set->numChars = 0;
+  while (*chars) {
+    if (!set->contains[(u8) *chars]) {
+      set->contains[(u8) *chars] = true;
+      if (set->numChars < BYTE_SET_MAX_SIMD_CHARS) {
+        set->chars[set->numChars] = *chars;
+      }
+      ++set->numChars;
+    }
+    ++chars;
+  }
+
+  return set;
+}
+
+#if _BYTE_SCAN_X86
+static size_t _ByteScan_countSse2(const char* s, size_t len, char c) {
+  const __m128i needle = _mm_set1_epi8(c);
+  size_t count = 0;
+  size_t i;
+  for (i = 0; i + 16 <= len; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*) (s + i));
+    count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+  }
+
+  return count + _ByteScan_countScalar(s + i, len - i, c);
+}
+
+_BYTE_SCAN_AVX2
+static size_t _ByteScan_countAvx2(const char* s, size_t len, char c) {
+  const __m256i needle = _mm256_set1_epi8(c);
+  size_t count = 0;
+  size_t i;
+  for (i = 0; i + 32 <= len; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*) (s + i));
+    count += __builtin_popcount(
+      (u32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+  }
+
+  return count + _ByteScan_countScalar(s + i, len - i, c);
+}
+
+/*
+ * Substring search compares the first and last needle bytes against 16 (or
+ * 32) positions at once and only runs memcmp() where both match.
+ */
+static size_t _ByteScan_findSse2(const char* s, size_t len, const char* needle,
+                                 size_t needleLen) {
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needleLen - 1]);
+  size_t i;
+  for (i = 0; i + needleLen - 1 + 16 <= len; i += 16) {
+    __m128i blockFirst = _mm_loadu_si128((const __m128i*) (s + i));
+    __m128i blockLast = _mm_loadu_si128((const __m128i*) (s + i + needleLen - 1));
+    u32 mask = (u32) _mm_movemask_epi8(
+      _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                    _mm_cmpeq_epi8(blockLast, last)));
+    while (mask) {
+      size_t at = i + __builtin_ctz(mask);
+      if (memcmp(s + at + 1, needle + 1, needleLen - 2) == 0) {
+        return at;
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  return i + _ByteScan_findScalar(s + i, len - i, needle, needleLen);
+}
+
+_BYTE_SCAN_AVX2
+static size_t _ByteScan_findAvx2(const char* s, size_t len, const char* needle,
+                                 size_t needleLen) {
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needleLen - 1]);
+  size_t i;
+  for (i = 0; i + needleLen - 1 + 32 <= len; i += 32) {
+    __m256i blockFirst = _mm256_loadu_si256((const __m256i*) (s + i));
+    __m256i blockLast = _mm256_loadu_si256((const __m256i*) (s + i + needleLen - 1));
+    u32 mask = (u32) _mm256_movemask_epi8(
+      _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                       _mm256_cmpeq_epi8(blockLast, last)));
+    while (mask) {
+      size_t at = i + __builtin_ctz(mask);
+      if (memcmp(s + at + 1, needle + 1, needleLen - 2) == 0) {
+        return at;
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  return i + _ByteScan_findScalar(s + i, len - i, needle, needleLen);
+}
+
+static size_t _ByteScan_findAnySse2(const char* s, size_t len,
+                                    const ByteSet* set) {
+  __m128i needles[BYTE_SET_MAX_SIMD_CHARS];
+  size_t i;
+  size_t j;
+  for (j = 0; j < set->numChars; ++j) {
+    needles[j] = _mm_set1_epi8(set->chars[j]);
+  }
+
+  for (i = 0; i + 16 <= len; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*) (s + i));
+    __m128i hits = _mm_cmpeq_epi8(block, needles[0]);
+    u32 mask;
+    for (j = 1; j < set->numChars; ++j) {
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needles[j]));
+    }
+
+    mask = (u32) _mm_movemask_epi8(hits);
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+
+  return i + _ByteScan_findAnyScalar(s + i, len - i, set);
+}
+
+_BYTE_SCAN_AVX2
+static size_t _ByteScan_findAnyAvx2(const char* s, size_t len,
+                                    const ByteSet* set) {
+  __m256i needles[BYTE_SET_MAX_SIMD_CHARS];
+  size_t i;
+  size_t j;
+  for (j = 0; j < set->numChars; ++j) {
+    needles[j] = _mm256_set1_epi8(set->chars[j]);
+  }
+
+  for (i = 0; i + 32 <= len; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*) (s + i));
+    __m256i hits = _mm256_cmpeq_epi8(block, needles[0]);
+    u32 mask;
+    for (j = 1; j < set->numChars; ++j) {
+      hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, needles[j]));
+    }
+
+    mask = (u32) _mm256_movemask_epi8(hits);
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+
+  return i + _ByteScan_findAnyScalar(s + i, len - i, set);
+}
+#endif
+
+/**
+ * Counts the occurrences of [c] in the first [len] bytes of [s].
+ */
+size_t ByteScan_count(const char* s, size_t len, char c) {
+#if _BYTE_SCAN_X86
+  if (_ByteScan_hasAvx2()) {
+    return _ByteScan_countAvx2(s, len, c);
+  }
+  return _ByteScan_countSse2(s, len, c);
+#else
+  return _ByteScan_countScalar(s, len, c);
+#endif
+}
+
+/**
+ * Finds the first occurrence of [needle] in [s]. An empty needle is found
+ * right at the start.
+ */
+size_t ByteScan_find(const char* s, size_t len, const char* needle,
+                     size_t needleLen) {
+  if (needleLen == 0) {
+    return 0;
+  } else if (needleLen > len) {
+    return len;
+  } else if (needleLen == 1) {
+    return ByteScan_findChar(s, len, needle[0]);
+  }
+
+#if _BYTE_SCAN_X86
+  if (_ByteScan_hasAvx2()) {
+    return _ByteScan_findAvx2(s, len, needle, needleLen);
+  }
+  return _ByteScan_findSse2(s, len, needle, needleLen);
+#else
+  return _ByteScan_findScalar(s, len, needle, needleLen);
+#endif
+}
+
+/**
+ * Finds the first byte of [s] that is in [set].
+ */
+size_t ByteScan_findAny(const char* s, size_t len, const ByteSet* set) {
+  if (set->numChars == 0) {
+    return len;
+  } else if (set->numChars == 1) {
+    return ByteScan_findChar(s, len, set->chars[0]);
+  }
+
+#if _BYTE_SCAN_X86
+  if (set->numChars <= BYTE_SET_MAX_SIMD_CHARS) {
+    if (_ByteScan_hasAvx2()) {
+      return _ByteScan_findAnyAvx2(s, len, set);
+    }
+    return _ByteScan_findAnySse2(s, len, set);
+  }
+#endif
+  return _ByteScan_findAnyScalar(s, len, set);
+}
+
+/**
+ * Finds the first [c] in [s]. memchr() is already vectorized by the C library
+ * wherever that pays off.
+ */
+size_t ByteScan_findChar(const char* s, size_t len, char c) {
+  const char* found = (const char*) memchr(s, c, len);
+  return found ? (size_t) (found - s) : len;
+}
+
+static size_t _ByteScan_countScalar(const char* s, size_t len, char c) {
+  size_t count = 0;
+  size_t i;
+  for (i = 0; i < len; ++i) {
+    count += s[i] == c;
+  }
+
+  return count;
+}
+
+static size_t _ByteScan_findScalar(const char* s, size_t len, const char* needle,
+                                   size_t needleLen) {
+  size_t i;
+  if (needleLen > len) {
+    return len;
+  }
+
+  for (i = 0; i + needleLen <= len; ++i) {
+    if (s[i] == needle[0] && memcmp(s + i, needle, needleLen) == 0) {
+      return i;
+    }
+  }
+
+  return len;
+}
+
+static size_t _ByteScan_findAnyScalar(const char* s, size_t len,
+                                      const ByteSet* set) {
+  size_t i;
+  for (i = 0; i < len; ++i) {
+    if (set->contains[(u8) s[i]]) {
+      return i;
+    }
+  }
+
+  return len;
+}
@@ -0,0 +1,178 @@
+#include "concurrentQueue.h"
+
+#ifndef __BCC__
+
+#include <stdio.h>
+#include <string.h>
+
+#define _CQ_NULL ((u32) 0xFFFFFFFF)
+#define _CQ_LINK(index, tag) (((u64) (tag) << 32) | (u32) (index))
+#define _CQ_INDEX(link) ((u32) (link))
+#define _CQ_TAG(link) ((u32) ((link) >> 32))
+
+/**
+ * @error  S_E_NOMEMS
+ */
+ConcurrentQueue* initConcurrentQueue(ConcurrentQueue* q, size_t typeSize,
+                                     SystemErrNoMems* se) {
+  size_t align = sizeof(((ConcurrentQueueNode*) NULL)->data[0]);
+  u32 dummy;
+  q->_typeSize = typeSize;
+  q->_nodeSize = (offsetof(ConcurrentQueueNode, data) + typeSize + align - 1) /
+                 align * align;
+  initSegmentedArray(&q->_nodes, q->_nodeSize, CONCURRENT_QUEUE_FIRST_SEGMENT);
+  atomic_init(&q->_nodesUsed, 0);
+  atomic_init(&q->_freeNodes, _CQ_LINK(_CQ_NULL, 0));
+
+  dummy = _ConcurrentQueue_allocNode(q, se);
+  if (!se->any) {
+    // The dummy was never pushed so nobody is going to pop its element
+    atomic_store(&_ConcurrentQueue_node(q, dummy)->refs, 1);
+    atomic_store(&_ConcurrentQueue_node(q, dummy)->next, _CQ_LINK(_CQ_NULL, 0));
+  }
+  atomic_init(&q->_head, _CQ_LINK(dummy, 0));
+  atomic_init(&q->_tail, _CQ_LINK(dummy, 0));
+  return q;
+}
+
+/**
+ * Not thread safe. Every other thread has to be done with the queue.
+ */
+void deinitConcurrentQueue(ConcurrentQueue* q) {
+  deinitSegmentedArray(&q->_nodes);
+}
+
+/**
+ * Safe from any number of threads.
+ * @error  S_E_NOMEMS
+ */
+void ConcurrentQueue_push(ConcurrentQueue* q, const void* data,
+                          SystemErrNoMems* se) {
+  ConcurrentQueueNode* node;
+  u64 tail;
+  u32 index = _ConcurrentQueue_allocNode(q, se);
+  if (se->any) {
+    return;
+  }
+
+  node = _ConcurrentQueue_node(q, index);
+  memcpy(node->data, data, q->_typeSize);
+  atomic_store(&node->refs, 2);
+  atomic_store(&node->next, _CQ_LINK(_CQ_NULL, _CQ_TAG(atomic_load(&node->next)) + 1));
+
+  for (;;) {
+    ConcurrentQueueNode* last;
+    u64 next;
+    tail = atomic_load(&q->_tail);
+    last = _ConcurrentQueue_node(q, _CQ_INDEX(tail));
+    next = atomic_load(&last->next);
+    if (tail != atomic_load(&q->_tail)) {
+      continue;
+    }
+
+    if (_CQ_INDEX(next) == _CQ_NULL) {
+      if (atomic_compare_exchange_weak(&last->next, &next,
+                                       _CQ_LINK(index, _CQ_TAG(next) + 1))) {
+        break;
+      }
+    } else {
+      // Another push linked its node but hasn't moved the tail yet. Help it.
+      atomic_compare_exchange_weak(&q->_tail, &tail,
+                                   _CQ_LINK(_CQ_INDEX(next), _CQ_TAG(tail) + 1));
+    }
+  }
+
+  atomic_compare_exchange_strong(&q->_tail, &tail,
+                                 _CQ_LINK(index, _CQ_TAG(tail) + 1));
+}
+
+/**
+ * Safe from any number of threads.
+ * @return  false if the queue is empty
+ */
+bool ConcurrentQueue_pop(ConcurrentQueue* q, void* out) {
+  u64 head;
+  u64 next;
+  for (;;) {
+    u64 tail;
+    head = atomic_load(&q->_head);
+    tail = atomic_load(&q->_tail);
+    next = atomic_load(&_ConcurrentQueue_node(q, _CQ_INDEX(head))->next);
+    if (head != atomic_load(&q->_head)) {
+      continue;
+    }
+
+    if (_CQ_INDEX(head) == _CQ_INDEX(tail)) {
+      if (_CQ_INDEX(next) == _CQ_NULL) {
+        return false;
+      }
+      atomic_compare_exchange_weak(&q->_tail, &tail,
+                                   _CQ_LINK(_CQ_INDEX(next), _CQ_TAG(tail) + 1));
+    } else if (atomic_compare_exchange_weak(&q->_head, &head,
+                                            _CQ_LINK(_CQ_INDEX(next),
+                                                     _CQ_TAG(head) + 1))) {
+      break;
+    }
+  }
+
+  // The new dummy holds a reference for its element until it's copied out,
+  // so it can't be recycled under us even if it gets popped past right away.
+  memcpy(out, _ConcurrentQueue_node(q, _CQ_INDEX(next))->data, q->_typeSize);
+  _ConcurrentQueue_releaseNode(q, _CQ_INDEX(next));
+  _ConcurrentQueue_releaseNode(q, _CQ_INDEX(head));
+  return true;
+}
+
+
+/**
+ * Pops a node off the free list, or hands out a new one.
+ * @error  S_E_NOMEMS
+ */
+u32 _ConcurrentQueue_allocNode(ConcurrentQueue* q, SystemErrNoMems* se) {
+  u32 index;
+  u64 top = atomic_load(&q->_freeNodes);
+  while (_CQ_INDEX(top) != _CQ_NULL) {
+    u64 below = atomic_load(&_ConcurrentQueue_node(q, _CQ_INDEX(top))->nextFree);
+    if (atomic_compare_exchange_weak(&q->_freeNodes, &top,
+                                     _CQ_LINK(_CQ_INDEX(below), _CQ_TAG(top) + 1))) {
+      return _CQ_INDEX(top);
+    }
+  }
+
+  index = atomic_fetch_add(&q->_nodesUsed, 1);
+  if (index == _CQ_NULL) {
+    se->any = true;
+    sprintf(se->msg, "ConcurrentQueue push: Out of node indexes");
+    return _CQ_NULL;
+  }
+
+  if (SegmentedArray_reserve(&q->_nodes, index, se) == NULL) {
+    return _CQ_NULL;
+  }
+
+  return index;
+}
+
+/**
+ * Drops a reference to the node at [index], putting it on the free list
+ * when it was the last one.
+ */
+void _ConcurrentQueue_releaseNode(ConcurrentQueue* q, u32 index) {
+  ConcurrentQueueNode* node = _ConcurrentQueue_node(q, index);
+  u64 top;
+  if (atomic_fetch_sub(&node->refs, 1) != 1) {
+    return;
+  }
+
+  top = atomic_load(&q->_freeNodes);
+  do {
+    atomic_store(&node->nextFree, top);
+  } while (!atomic_compare_exchange_weak(&q->_freeNodes, &top,
+                                         _CQ_LINK(index, _CQ_TAG(top) + 1)));
+}
+
+ConcurrentQueueNode* _ConcurrentQueue_node(ConcurrentQueue* q, u32 index) {
+  return (ConcurrentQueueNode*) SegmentedArray_at(&q->_nodes, index);
+}
+
+#endif
@@ -0,0 +1,151 @@
+#include "concurrentVector.h"
+
+#ifndef __BCC__
+
+#include <stdio.h>
+#include <string.h>
+
+ConcurrentVector* initConcurrentVector(ConcurrentVector* cv, size_t typeSize,
+                                       void* (*cpInitializer)(void*, const void*, Err*),
+                                       void (*deInitializer)(void*)) {
+  return initConcurrentVectorAdvanced(cv, typeSize, _VECTOR_DEFAULT_INIT_SIZE,
+                                      cpInitializer, deInitializer);
+}
+
+/**
+ * [initSize] is the length of the first segment. Nothing is allocated until
+ * the first add.
+ */
+ConcurrentVector* initConcurrentVectorAdvanced(ConcurrentVector* cv,
+                                               size_t typeSize, size_t initSize,
+                                               void* (*cpInitializer)(void*, const void*, Err*),
+                                               void (*deInitializer)(void*)) {
+  initSegmentedArray(&cv->_elements, typeSize, initSize);
+  initSegmentedArray(&cv->_ready, sizeof(CP_ATOMIC(u8)), initSize);
+  cv->_copyInitializer = cpInitializer;
+  cv->_deInitializer = deInitializer;
+  cv->_typeSize = typeSize;
+  atomic_init(&cv->_length, 0);
+  return cv;
+}
+
+/**
+ * Not thread safe. Every other thread has to be done with the vector.
+ */
+void deinitConcurrentVector(ConcurrentVector* cv) {
+  size_t i;
+  size_t length = atomic_load(&cv->_length);
+  if (cv->_deInitializer) {
+    for (i = 0; i < length; ++i) {
+      if (_ConcurrentVector_isReady(cv, i)) {
+        cv->_deInitializer(SegmentedArray_at(&cv->_elements, i));
+      }
+    }
+  }
+
+  deinitSegmentedArray(&cv->_elements);
+  deinitSegmentedArray(&cv->_ready);
+}
+
+/**
+ * Safe from any number of threads.
+ * @return  The index the copy of [data] ended up at
+ * @error   S_E_NOMEMS
+ */
+size_t ConcurrentVector_add(ConcurrentVector* cv, const void* data,
+                            SystemErrNoMems* se) {
+  return ConcurrentVector_catPrimitive(cv, data, 1, se);
+}
+
+/**
+ * Adds the [num] elements of the array [data] at consecutive indexes with a
+ * single claim, which is the way to go for batches. Safe from any number of
+ * threads.
+ * @return  The index of the first element
+ * @error   S_E_NOMEMS
+ */
+size_t ConcurrentVector_catPrimitive(ConcurrentVector* cv, const void* data,
+                                     size_t num, SystemErrNoMems* se) {
+  size_t first = atomic_fetch_add_explicit(&cv->_length, num, memory_order_relaxed);
+  size_t i;
+  for (i = 0; i < num && !se->any; ++i) {
+    char* element = (char*) SegmentedArray_reserve(&cv->_elements, first + i, se);
+    CP_ATOMIC(u8)* ready = (CP_ATOMIC(u8)*) SegmentedArray_reserve(&cv->_ready,
+                                                                   first + i, se);
+    const char* item = (const char*) data + i * cv->_typeSize;
+    if (se->any) {
+      break;
+    }
+
+    if (cv->_copyInitializer) {
+      cv->_copyInitializer(element, item, se);
+    } else {
+      memcpy(element, item, cv->_typeSize);
+    }
+
+    if (!se->any) {
+      atomic_store_explicit(ready, 1, memory_order_release);
+    }
+  }
+
+  return first;
+}
+
+/**
+ * Returns a pointer to the element at [index]. Safe from any number of
+ * threads, even while others are adding.
+ * @error  V_E_RANGE  If the element at [index] isn't there (yet)
+ */
+void* ConcurrentVector_at(ConcurrentVector* cv, size_t index, VectorErrRange* e) {
+  size_t length = atomic_load_explicit(&cv->_length, memory_order_relaxed);
+  if (index >= length || !_ConcurrentVector_isReady(cv, index)) {
+    e->any = true;
+    sprintf(e->msg, "Range error: Index %lu out of range %lu",
+            (unsigned long) index, (unsigned long) length);
+    return NULL;
+  }
+
+  return SegmentedArray_at(&cv->_elements, index);
+}
+
+/**
+ * Calls [fn] on every element that has been added, in index order, passing
+ * [context] along.
+ */
+void ConcurrentVector_forEach(ConcurrentVector* cv,
+                              void (*fn)(void* item, void* context),
+                              void* context) {
+  size_t i;
+  size_t length = atomic_load_explicit(&cv->_length, memory_order_relaxed);
+  for (i = 0; i < length; ++i) {
+    if (_ConcurrentVector_isReady(cv, i)) {
+      fn(SegmentedArray_at(&cv->_elements, i), context);
+    }
+  }
+}
+
+/**
+ * The number of indexes claimed so far, including adds still in progress.
+ */
+size_t ConcurrentVector_length(ConcurrentVector* cv) {
+  return atomic_load_explicit(&cv->_length, memory_order_relaxed);
+}
+
+/**
+ * Whether the element at [index] has been fully added. A claimed index's
+ * segment may not even be allocated yet.
+ */
+bool _ConcurrentVector_isReady(ConcurrentVector* cv, size_t index) {
+  size_t offset;
+  size_t segment = _SegmentedArray_segmentOf(&cv->_ready, index, &offset);
+  CP_ATOMIC(u8)* flags;
+  if (segment >= SEGMENTED_ARRAY_SEGMENTS) {
+    return false;
+  }
+
+  flags = (CP_ATOMIC(u8)*) atomic_load_explicit(&cv->_ready._segments[segment],
+                                                memory_order_acquire);
+  return flags && atomic_load_explicit(flags + offset, memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,343 @@
+#include "doubleLinkedList.h"
+
+#ifndef __BCC__
+
+#include "stdlib.h"
+#include "string.h"
+
+DoubleLinkedNode* _DoubleLinkedList_newNode(DoubleLinkedList* list,
+                                            const void* data, SystemErr* se);
+void _DoubleLinkedList_releaseNode(DoubleLinkedList* list, DoubleLinkedNode* node);
+
+DoubleLinkedList* initDoubleLinkedList(DoubleLinkedList* list, size_t typeSize,
+                                       void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                       void (*deInitializer)(void*)) {
+  return initDoubleLinkedListPooled(list, typeSize, copyInitializer,
+                                    deInitializer, NULL);
+}
+
+DoubleLinkedList* initDoubleLinkedListCp(DoubleLinkedList* list,
+                                         const DoubleLinkedList* copy,
+                                         SystemErr* se) {
+  DoubleLinkedNode* nextNode = copy->firstNode;
+  initDoubleLinkedListPooled(list, copy->_typeSize, copy->_copyInitializer,
+                             copy->_deInitializer, copy->_pool);
+  while (nextNode != NULL && !*se) {
+    DoubleLinkedList_append(list, nextNode->data, se);
+    nextNode = nextNode->next;
+  }
+
+  return list;
+}
+
+/**
+ * Like initDoubleLinkedList() but nodes come out of [pool], which must have
+ * been initialized with a slot size of at least
+ * DoubleLinkedList_nodeSize([typeSize]).
+ */
+DoubleLinkedList* initDoubleLinkedListPooled(DoubleLinkedList* list, size_t typeSize,
+                                             void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                             void (*deInitializer)(void*),
+                                             NodePool* pool) {
+  list->firstNode = NULL;
+  list->lastNode = NULL;
+  list->length = 0;
+  list->_copyInitializer = copyInitializer;
+  list->_deInitializer = deInitializer;
+  list->_typeSize = typeSize;
+  list->_pool = pool;
+  return list;
+}
+
+void deinitDoubleLinkedList(DoubleLinkedList* list) {
+  DoubleLinkedList_clear(list);
+}
+
+
+void DoubleLinkedList_append(DoubleLinkedList* list, const void* data,
+                             SystemErr* se) {
+  DoubleLinkedList_insertBefore(list, NULL, data, se);
+}
+
+/**
+ * Appends a zeroed element and returns it to be initialized.
+ * @error  S_E_NOMEMS
+ */
+void* DoubleLinkedList_appendEmpty(DoubleLinkedList* list, SystemErr* se) {
+  DoubleLinkedNode* node = DoubleLinkedList_insertBefore(list, NULL, NULL, se);
+  return node ? node->data : NULL;
+}
+
+void DoubleLinkedList_prepend(DoubleLinkedList* list, const void* data,
+                              SystemErr* se) {
+  DoubleLinkedList_insertAfter(list, NULL, data, se);
+}
+
+/**
+ * Inserts a copy of [data] right after [node], or at the front if [node] is
+ * NULL. A NULL [data] inserts a zeroed element.
+ * @return  The new node
+ * @error   S_E_NOMEMS
+ */
+DoubleLinkedNode* DoubleLinkedList_insertAfter(DoubleLinkedList* list,
+                                               DoubleLinkedNode* node,
+                                               const void* data, SystemErr* se) {
+  return DoubleLinkedList_insertBefore(list, node ? node->next : list->firstNode,
+                                       data, se);
+}
+
+/**
+ * Inserts a copy of [data] right before [node], or at the end if [node] is
+ * NULL. A NULL [data] inserts a zeroed element.
+ * @return  The new node
+ * @error   S_E_NOMEMS
+ */
+DoubleLinkedNode* DoubleLinkedList_insertBefore(DoubleLinkedList* list,
+                                                DoubleLinkedNode* node,
+                                                const void* data, SystemErr* se) {
+  DoubleLinkedNode* newNode = _DoubleLinkedList_newNode(list, data, se);
+  if (newNode != NULL) {
+    _DoubleLinkedList_link(list, node, newNode, newNode);
+    list->length++;
+  }
+
+  return newNode;
+}
+
+
+void* DoubleLinkedList_first(const DoubleLinkedList* list) {
+  return list->firstNode->data;
+}
+
+void* DoubleLinkedList_last(const DoubleLinkedList* list) {
+  return list->lastNode->data;
+}
+
+void DoubleLinkedList_clear(DoubleLinkedList* list) {
+  DoubleLinkedNode* nextNode = list->firstNode;
+  while (nextNode != NULL) {
+    DoubleLinkedNode* tmp = nextNode->next;
+    _DoubleLinkedList_releaseNode(list, nextNode);
+    nextNode = tmp;
+  }
+
+  list->length = 0;
+  list->firstNode = NULL;
+  list->lastNode = NULL;
+}
+
+
+/**
+ * Removes [node], which must be in [list], and frees it.
+ */
+void DoubleLinkedList_remove(DoubleLinkedList* list, DoubleLinkedNode* node) {
+  _DoubleLinkedList_unlink(list, node, node);
+  _DoubleLinkedList_releaseNode(list, node);
+  list->length--;
+}
+
+void DoubleLinkedList_removeFirst(DoubleLinkedList* list) {
+  DoubleLinkedList_remove(list, list->firstNode);
+}
+
+void DoubleLinkedList_removeLast(DoubleLinkedList* list) {
+  DoubleLinkedList_remove(list, list->lastNode);
+}
+
+/**
+ * Finds an item in the list with the given comparison function.
+ * @errors LL_E_NOT_FOUND
+ */
+void* DoubleLinkedList_find(DoubleLinkedList* list, void* dataToFind,
+                            bool (*cmp)(void* dataToFind, void* itemData),
+                            LLErr* le) {
+  DoubleLinkedNode* node = DoubleLinkedList_findNode(list, dataToFind, cmp, le);
+  return node ? node->data : NULL;
+}
+
+/**
+ * Same as DoubleLinkedList_find() but gives the node, to be used as a
+ * cursor.
+ * @errors LL_E_NOT_FOUND
+ */
+DoubleLinkedNode* DoubleLinkedList_findNode(DoubleLinkedList* list,
+                                            void* dataToFind,
+                                            bool (*cmp)(void* dataToFind, void* itemData),
+                                            LLErr* le) {
+  DoubleLinkedNode* node = list->firstNode;
+  while (node != NULL) {
+    if (cmp(dataToFind, node->data)) {
+      return node;
+    }
+
+    node = node->next;
+  }
+
+  *le = LL_E_NOT_FOUND;
+
+  return NULL;
+}
+
+/**
+ * Moves every node of [other] onto the end of [list] in O(1). [other] is
+ * left empty. A list concatenated with itself is left as it is. Both lists
+ * must hold the same type and get their nodes from the same place (the same
+ * NodePool, or both none).
+ * @errors LL_E_INCOMPATIBLE
+ */
+void DoubleLinkedList_concat(DoubleLinkedList* list, DoubleLinkedList* other,
+                             LLErr* le) {
+  if (list->_typeSize != other->_typeSize || list->_pool != other->_pool) {
+    *le = LL_E_INCOMPATIBLE;
+    return;
+  }
+
+  // Linking the nodes onto themselves and then emptying [other] would lose
+  // all of them
+  if (list == other) {
+    return;
+  }
+
+  if (other->firstNode != NULL) {
+    _DoubleLinkedList_link(list, NULL, other->firstNode, other->lastNode);
+    list->length += other->length;
+    other->firstNode = NULL;
+    other->lastNode = NULL;
+    other->length = 0;
+  }
+}
+
+/**
+ * Moves the nodes from [first] through [last] out of [other] and into [list]
+ * right before [before] (at the end if NULL). Nothing is copied, but the
+ * moved nodes are counted to keep the lengths right. [other] may be [list]
+ * as long as [before] isn't one of the moved nodes. Both lists must be
+ * compatible as with DoubleLinkedList_concat().
+ * @errors LL_E_INCOMPATIBLE
+ */
+void DoubleLinkedList_splice(DoubleLinkedList* list, DoubleLinkedNode* before,
+                             DoubleLinkedList* other, DoubleLinkedNode* first,
+                             DoubleLinkedNode* last, LLErr* le) {
+  DoubleLinkedNode* node = first;
+  size_t moved = 1;
+  if (list->_typeSize != other->_typeSize || list->_pool != other->_pool) {
+    *le = LL_E_INCOMPATIBLE;
+    return;
+  }
+
+  while (node != last) {
+    node = node->next;
+    moved++;
+  }
+
+  _DoubleLinkedList_unlink(other, first, last);
+  _DoubleLinkedList_link(list, before, first, last);
+  other->length -= moved;
+  list->length += moved;
+}
+
+/**
+ * Gives the node holding [data], for data returned by the list.
+ */
+DoubleLinkedNode* DoubleLinkedList_nodeOf(void* data) {
+  return (DoubleLinkedNode*) ((char*) data - offsetof(DoubleLinkedNode, data));
+}
+
+/**
+ * Bytes taken by one node holding an element of [typeSize] bytes. Also the
+ * slot size a NodePool needs to serve the list.
+ */
+size_t DoubleLinkedList_nodeSize(size_t typeSize) {
+  return offsetof(DoubleLinkedNode, data) + typeSize;
+}
+
+/**
+ * Links the chain [first] through [last] into [list] before [before], or at
+ * the end if it's NULL. The length is left to the caller.
+ */
+void _DoubleLinkedList_link(DoubleLinkedList* list, DoubleLinkedNode* before,
+                            DoubleLinkedNode* first, DoubleLinkedNode* last) {
+  DoubleLinkedNode* after = before ? before->prev : list->lastNode;
+  first->prev = after;
+  last->next = before;
+
+  if (after) {
+    after->next = first;
+  } else {
+    list->firstNode = first;
+  }
+
+  if (before) {
+    before->prev = last;
+  } else {
+    list->lastNode = last;
+  }
+}
+
+/**
+ * Takes the chain [first] through [last] out of [list]. The length is left to
+ * the caller.
+ */
+void _DoubleLinkedList_unlink(DoubleLinkedList* list, DoubleLinkedNode* first,
+                              DoubleLinkedNode* last) {
+  if (first->prev) {
+    first->prev->next = last->next;
+  } else {
+    list->firstNode = last->next;
+  }
+
+  if (last->next) {
+    last->next->prev = first->prev;
+  } else {
+    list->lastNode = first->prev;
+  }
+
+  first->prev = NULL;
+  last->next = NULL;
+}
+
+/**
+ * Allocates a node and copies [data] into it, or zeroes it if [data] is NULL.
+ * @error  S_E_NOMEMS
+ */
+DoubleLinkedNode* _DoubleLinkedList_newNode(DoubleLinkedList* list,
+                                            const void* data, SystemErr* se) {
+  DoubleLinkedNode* node;
+  if (list->_pool) {
+    node = (DoubleLinkedNode*) NodePool_alloc(list->_pool, se);
+  } else {
+    node = (DoubleLinkedNode*) malloc(DoubleLinkedList_nodeSize(list->_typeSize));
+    if (node == NULL) {
+      *se = S_E_NOMEMS;
+    }
+  }
+
+  if (node != NULL) {
+    node->prev = NULL;
+    node->next = NULL;
+    if (data == NULL) {
+      memset(node->data, 0, list->_typeSize);
+    } else if (list->_copyInitializer) {
+      memset(node->data, 0, list->_typeSize);
+      list->_copyInitializer(node->data, data, se);
+    } else {
+      memcpy(node->data, data, list->_typeSize);
+    }
+  }
+
+  return node;
+}
+
+void _DoubleLinkedList_releaseNode(DoubleLinkedList* list, DoubleLinkedNode* node) {
+  if (list->_deInitializer) {
+    list->_deInitializer(node->data);
+  }
+
+  if (list->_pool) {
+    NodePool_free(list->_pool, node);
+  } else {
+    free(node);
+  }
+}
+
+#endif
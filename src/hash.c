@@ -0,0 +1,109 @@
+#include "hash.h"
+
+#ifndef __BCC__
+
+#include "string.h"
+
+/*
+ * A wyhash style hash: fast, not cryptographic, and good enough to drive hash
+ * tables. Input is consumed 48 bytes at a time through three independent
+ * multiply-mix lanes.
+ */
+
+#define _HASH_P0 0xa0761d6478bd642fULL
+#define _HASH_P1 0xe7037ed1a0b428dbULL
+#define _HASH_P2 0x8ebc6af09c88c6e3ULL
+#define _HASH_P3 0x589965cc75374cc3ULL
+
+/**
+ * Multiplies [a] by [b] into 128 bits, leaving the low half in [a] and the
+ * high half in [b].
+ */
+static void _Hash_multiply(u64* a, u64* b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = (__uint128_t) *a * *b;
+  *a = (u64) r;
+  *b = (u64) (r >> 64);
+#else
+  u64 ha = *a >> 32, hb = *b >> 32, la = (u32) *a, lb = (u32) *b;
+  u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  u64 t = rl + (rm0 << 32);
+  u64 c = t < rl;
+  u64 lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static u64 _Hash_mix(u64 a, u64 b) {
+  _Hash_multiply(&a, &b);
+  return a ^ b;
+}
+
+static u64 _Hash_read64(const u8* p) {
+  u64 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static u64 _Hash_read32(const u8* p) {
+  u32 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/**
+ * Hashes [len] bytes at [key]. Different [seed]s give unrelated hashes.
+ */
+u64 Hash_bytes(const void* key, size_t len, u64 seed) {
+  const u8* p = (const u8*) key;
+  u64 a;
+  u64 b;
+  size_t i = len;
+  seed ^= _Hash_mix(seed ^ _HASH_P0, _HASH_P1);
+
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t middle = (len >> 3) << 2;
+      a = (_Hash_read32(p) << 32) | _Hash_read32(p + middle);
+      b = (_Hash_read32(p + len - 4) << 32) | _Hash_read32(p + len - 4 - middle);
+    } else if (len > 0) {
+      a = ((u64) p[0] << 16) | ((u64) p[len >> 1] << 8) | p[len - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    if (i > 48) {
+      u64 seed1 = seed;
+      u64 seed2 = seed;
+      do {
+        seed = _Hash_mix(_Hash_read64(p) ^ _HASH_P1, _Hash_read64(p + 8) ^ seed);
+        seed1 = _Hash_mix(_Hash_read64(p + 16) ^ _HASH_P2,
+                          _Hash_read64(p + 24) ^ seed1);
+        seed2 = _Hash_mix(_Hash_read64(p + 32) ^ _HASH_P3,
+                          _Hash_read64(p + 40) ^ seed2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= seed1 ^ seed2;
+    }
+
+    while (i > 16) {
+      seed = _Hash_mix(_Hash_read64(p) ^ _HASH_P1, _Hash_read64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+
+    a = _Hash_read64(p + i - 16);
+    b = _Hash_read64(p + i - 8);
+  }
+
+  a ^= _HASH_P1;
+  b ^= seed;
+  _Hash_multiply(&a, &b);
+  return _Hash_mix(a ^ _HASH_P0 ^ len, b ^ _HASH_P1);
+}
+
+#endif
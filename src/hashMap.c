@@ -0,0 +1,561 @@
+#include "hashMap.h"
+
+#ifndef __BCC__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "allocStats.h"
+#include "hash.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define _HASH_MAP_EMPTY ((u8) 0x80)
+#define _HASH_MAP_DELETED ((u8) 0xFE)
+#define _HASH_MAP_H1(hash) ((size_t) ((hash) >> 7))
+#define _HASH_MAP_H2(hash) ((u8) ((hash) & 0x7F))
+
+// A table is rehashed once it's 7/8 full
+#define _HASH_MAP_MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+static u32 _HashMap_matchByte(const u8* group, u8 ctrl);
+static u32 _HashMap_matchEmptyOrDeleted(const u8* group);
+static size_t _HashMap_alignOf(size_t size);
+static u64 _HashMap_hashString(const void* str);
+static bool _HashMap_equalsString(const void* str, const void* otherStr);
+static bool _HashMap_equalsView(const void* view, const void* str);
+static void* _HashMap_copyString(void* str, const void* copyStr, Err* se);
+static void _HashMap_deinitString(void* str);
+
+/**
+ * Sets up an empty map. [hash] and [equals] may be NULL to hash and compare
+ * the raw key bytes.
+ * @error  S_E_NOMEMS
+ */
+HashMap* initHashMap(HashMap* map, size_t keySize, size_t valueSize,
+                     u64 (*hash)(const void*),
+                     bool (*equals)(const void*, const void*),
+                     SystemErrNoMems* se) {
+  size_t keyAlign = _HashMap_alignOf(keySize);
+  size_t valueAlign = _HashMap_alignOf(valueSize);
+  size_t slotAlign = keyAlign > valueAlign ? keyAlign : valueAlign;
+  map->length = 0;
+  map->_ctrl = NULL;
+  map->_slots = NULL;
+  map->_capacity = 0;
+  map->_growthLeft = 0;
+  map->_keySize = keySize;
+  map->_valueSize = valueSize;
+  map->_valueOffset = (keySize + valueAlign - 1) / valueAlign * valueAlign;
+  map->_slotSize = (map->_valueOffset + valueSize + slotAlign - 1) /
+                   slotAlign * slotAlign;
+  map->_hash = hash;
+  map->_equals = equals;
+  map->_keyCopyInitializer = NULL;
+  map->_keyDeInitializer = NULL;
+  map->_valueCopyInitializer = NULL;
+  map->_valueDeInitializer = NULL;
+
+  _HashMap_rehash(map, HASH_MAP_MIN_CAPACITY, se);
+  return map;
+}
+
+/**
+ * A map with String keys. Keys are copied in with initStringN() and can be
+ * looked up with a StringView through HashMap_getView() without making a
+ * String first.
+ * @error  S_E_NOMEMS
+ */
+HashMap* initStringHashMap(HashMap* map, size_t valueSize, SystemErrNoMems* se) {
+  initHashMap(map, sizeof(String), valueSize, _HashMap_hashString,
+              _HashMap_equalsString, se);
+  HashMap_setKeyInitializers(map, _HashMap_copyString, _HashMap_deinitString);
+  return map;
+}
+
+void deinitHashMap(HashMap* map) {
+  if (map->_ctrl) {
+    HashMap_clear(map);
+    free(map->_ctrl);
+    free(map->_slots);
+    AllocStats_recordRelease(ALLOC_KIND_HASH_MAP,
+                             map->_capacity * (1 + map->_slotSize) +
+                             HASH_MAP_GROUP);
+    map->_ctrl = NULL;
+    map->_slots = NULL;
+    map->_capacity = 0;
+    map->_growthLeft = 0;
+  }
+}
+
+void HashMap_setKeyInitializers(HashMap* map,
+                                void* (*cpInitializer)(void*, const void*, Err*),
+                                void (*deInitializer)(void*)) {
+  map->_keyCopyInitializer = cpInitializer;
+  map->_keyDeInitializer = deInitializer;
+}
+
+void HashMap_setValueInitializers(HashMap* map,
+                                  void* (*cpInitializer)(void*, const void*, Err*),
+                                  void (*deInitializer)(void*)) {
+  map->_valueCopyInitializer = cpInitializer;
+  map->_valueDeInitializer = deInitializer;
+}
+
+
+/**
+ * Removes every entry but keeps the table's capacity.
+ */
+void HashMap_clear(HashMap* map) {
+  size_t i;
+  if (map->_ctrl == NULL) {
+    return;
+  }
+
+  for (i = 0; i < map->_capacity && map->length; ++i) {
+    if (!(map->_ctrl[i] & _HASH_MAP_EMPTY)) {
+      char* key = (char*) _HashMap_keyAt(map, i);
+      if (map->_keyDeInitializer) {
+        map->_keyDeInitializer(key);
+      }
+      if (map->_valueDeInitializer) {
+        map->_valueDeInitializer(key + map->_valueOffset);
+      }
+      map->length--;
+    }
+  }
+
+  memset(map->_ctrl, _HASH_MAP_EMPTY, map->_capacity + HASH_MAP_GROUP);
+  map->length = 0;
+  map->_growthLeft = _HASH_MAP_MAX_LOAD(map->_capacity);
+}
+
+bool HashMap_contains(const HashMap* map, const void* key) {
+  return _HashMap_find(map, key, _HashMap_hash(map, key), map->_equals) !=
+         HASH_MAP_NPOS;
+}
+
+/**
+ * Finds the value for [key], inserting a copy of [key] with a zeroed value
+ * if it isn't there. [inserted], if not NULL, tells which happened. A new
+ * value must be initialized by the caller, which makes this the way to
+ * update a value in place, e.g. counting.
+ * @return  The value or NULL on error
+ * @error   S_E_NOMEMS
+ */
+void* HashMap_emplace(HashMap* map, const void* key, bool* inserted,
+                      SystemErrNoMems* se) {
+  u64 hash = _HashMap_hash(map, key);
+  size_t i = _HashMap_find(map, key, hash, map->_equals);
+  char* slot;
+  if (inserted) {
+    *inserted = i == HASH_MAP_NPOS;
+  }
+
+  if (i != HASH_MAP_NPOS) {
+    return (char*) _HashMap_keyAt(map, i) + map->_valueOffset;
+  }
+
+  // There's no table after a failed init or a deinit
+  if (map->_ctrl == NULL) {
+    _HashMap_rehash(map, HASH_MAP_MIN_CAPACITY, se);
+    if (se->any) {
+      return NULL;
+    }
+  }
+
+  i = _HashMap_findInsertSlot(map, hash);
+  if (map->_growthLeft == 0 && map->_ctrl[i] == _HASH_MAP_EMPTY) {
+    // Lots of tombstones are cleaned up in place, otherwise the table grows
+    _HashMap_rehash(map, map->length < map->_capacity / 2 ?
+                    map->_capacity : map->_capacity * 2, se);
+    if (se->any) {
+      return NULL;
+    }
+    i = _HashMap_findInsertSlot(map, hash);
+  }
+
+  slot = (char*) _HashMap_keyAt(map, i);
+  memset(slot, 0, map->_slotSize);
+  if (map->_keyCopyInitializer) {
+    map->_keyCopyInitializer(slot, key, se);
+    if (se->any) {
+      return NULL;
+    }
+  } else {
+    memcpy(slot, key, map->_keySize);
+  }
+
+  if (map->_ctrl[i] == _HASH_MAP_EMPTY) {
+    map->_growthLeft--;
+  }
+  _HashMap_setCtrl(map, i, _HASH_MAP_H2(hash));
+  map->length++;
+  return slot + map->_valueOffset;
+}
+
+/**
+ * @return  The value for [key] or NULL if it isn't in the map
+ */
+void* HashMap_get(const HashMap* map, const void* key) {
+  size_t i = _HashMap_find(map, key, _HashMap_hash(map, key), map->_equals);
+  return i == HASH_MAP_NPOS ? NULL :
+         (char*) _HashMap_keyAt(map, i) + map->_valueOffset;
+}
+
+/**
+ * HashMap_get() for a map made with initStringHashMap(), looking [key] up
+ * without copying it into a String.
+ */
+void* HashMap_getView(const HashMap* map, const StringView* key) {
+  size_t i = _HashMap_find(map, key, StringView_hash(key), _HashMap_equalsView);
+  return i == HASH_MAP_NPOS ? NULL :
+         (char*) _HashMap_keyAt(map, i) + map->_valueOffset;
+}
+
+/**
+ * Steps through the entries in no particular order. [iter] must start out
+ * as 0. [key] and [value] may be NULL.
+ * @return  false once there are no more entries
+ */
+bool HashMap_next(const HashMap* map, size_t* iter, void** key, void** value) {
+  for (; *iter < map->_capacity; ++*iter) {
+    if (!(map->_ctrl[*iter] & _HASH_MAP_EMPTY)) {
+      char* slot = (char*) _HashMap_keyAt(map, (*iter)++);
+      if (key) {
+        *key = slot;
+      }
+      if (value) {
+        *value = slot + map->_valueOffset;
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Maps [key] to a copy of [value], replacing any value it had. If copying
+ * [value] fails a new [key] is taken back out, a replaced value is left zeroed.
+ * @return  The value in the map or NULL on error
+ * @error   S_E_NOMEMS
+ */
+void* HashMap_put(HashMap* map, const void* key, const void* value,
+                  SystemErrNoMems* se) {
+  bool inserted;
+  void* slot = HashMap_emplace(map, key, &inserted, se);
+  if (slot == NULL) {
+    return NULL;
+  }
+
+  if (!inserted && map->_valueDeInitializer) {
+    map->_valueDeInitializer(slot);
+    memset(slot, 0, map->_valueSize);
+  }
+
+  if (map->_valueCopyInitializer) {
+    map->_valueCopyInitializer(slot, value, se);
+    if (se->any) {
+      if (inserted) {
+        HashMap_remove(map, key);
+      }
+      return NULL;
+    }
+  } else {
+    memcpy(slot, value, map->_valueSize);
+  }
+
+  return slot;
+}
+
+/**
+ * @return  Whether [key] was in the map
+ */
+bool HashMap_remove(HashMap* map, const void* key) {
+  size_t i = _HashMap_find(map, key, _HashMap_hash(map, key), map->_equals);
+  size_t before;
+  u32 emptyBefore;
+  u32 emptyAfter;
+  char* slot;
+  if (i == HASH_MAP_NPOS) {
+    return false;
+  }
+
+  slot = (char*) _HashMap_keyAt(map, i);
+  if (map->_keyDeInitializer) {
+    map->_keyDeInitializer(slot);
+  }
+  if (map->_valueDeInitializer) {
+    map->_valueDeInitializer(slot + map->_valueOffset);
+  }
+
+  // The slot can go back to empty if no group of 16 spanning it was ever
+  // full, since then no probe could have passed over it.
+  before = (i - HASH_MAP_GROUP) & (map->_capacity - 1);
+  emptyBefore = _HashMap_matchByte(map->_ctrl + before, _HASH_MAP_EMPTY);
+  emptyAfter = _HashMap_matchByte(map->_ctrl + i, _HASH_MAP_EMPTY);
+  if (emptyBefore && emptyAfter &&
+      (u32) __builtin_ctz(emptyAfter) + (u32) (__builtin_clz(emptyBefore) - 16) <
+      HASH_MAP_GROUP) {
+    _HashMap_setCtrl(map, i, _HASH_MAP_EMPTY);
+    map->_growthLeft++;
+  } else {
+    _HashMap_setCtrl(map, i, _HASH_MAP_DELETED);
+  }
+
+  map->length--;
+  return true;
+}
+
+/**
+ * Makes room for [num] entries in total without rehashing. A map without a
+ * table, after a failed init or a deinit, gets one.
+ * @error  S_E_NOMEMS
+ */
+void HashMap_reserve(HashMap* map, size_t num, SystemErrNoMems* se) {
+  size_t capacity = map->_capacity ? map->_capacity : HASH_MAP_MIN_CAPACITY;
+  while (_HASH_MAP_MAX_LOAD(capacity) < num) {
+    capacity *= 2;
+  }
+
+  if (capacity != map->_capacity || map->_ctrl == NULL) {
+    _HashMap_rehash(map, capacity, se);
+  }
+}
+
+
+HashSet* initHashSet(HashSet* set, size_t keySize, u64 (*hash)(const void*),
+                     bool (*equals)(const void*, const void*),
+                     SystemErrNoMems* se) {
+  return initHashMap(set, keySize, 0, hash, equals, se);
+}
+
+HashSet* initStringHashSet(HashSet* set, SystemErrNoMems* se) {
+  return initStringHashMap(set, 0, se);
+}
+
+void deinitHashSet(HashSet* set) {
+  deinitHashMap(set);
+}
+
+/**
+ * @return  Whether [key] was added, false if it was already there
+ * @error   S_E_NOMEMS
+ */
+bool HashSet_add(HashSet* set, const void* key, SystemErrNoMems* se) {
+  bool inserted = false;
+  HashMap_emplace(set, key, &inserted, se);
+  return inserted && !se->any;
+}
+
+bool HashSet_contains(const HashSet* set, const void* key) {
+  return HashMap_contains(set, key);
+}
+
+bool HashSet_remove(HashSet* set, const void* key) {
+  return HashMap_remove(set, key);
+}
+
+
+/**
+ * Probes a group of control bytes at a time, jumping a growing number of
+ * groups each time, which visits every group of a power of two table.
+ * @return  The slot holding [key] or HASH_MAP_NPOS
+ */
+size_t _HashMap_find(const HashMap* map, const void* key, u64 hash,
+                     bool (*equals)(const void*, const void*)) {
+  size_t mask = map->_capacity - 1;
+  size_t pos = _HASH_MAP_H1(hash) & mask;
+  size_t step = 0;
+  u8 h2 = _HASH_MAP_H2(hash);
+  if (map->_ctrl == NULL) {
+    return HASH_MAP_NPOS;
+  }
+
+  for (;;) {
+    u32 matches = _HashMap_matchByte(map->_ctrl + pos, h2);
+    while (matches) {
+      size_t i = (pos + __builtin_ctz(matches)) & mask;
+      const void* slot = _HashMap_keyAt(map, i);
+      if (equals ? equals(key, slot) : memcmp(key, slot, map->_keySize) == 0) {
+        return i;
+      }
+      matches &= matches - 1;
+    }
+
+    if (_HashMap_matchByte(map->_ctrl + pos, _HASH_MAP_EMPTY)) {
+      return HASH_MAP_NPOS;
+    }
+
+    step += HASH_MAP_GROUP;
+    pos = (pos + step) & mask;
+  }
+}
+
+/**
+ * The first empty or deleted slot along [hash]'s probe sequence. The map
+ * must have a table, which HashMap_emplace() makes sure of.
+ */
+size_t _HashMap_findInsertSlot(const HashMap* map, u64 hash) {
+  size_t mask = map->_capacity - 1;
+  size_t pos = _HASH_MAP_H1(hash) & mask;
+  size_t step = 0;
+  for (;;) {
+    u32 free = _HashMap_matchEmptyOrDeleted(map->_ctrl + pos);
+    if (free) {
+      return (pos + __builtin_ctz(free)) & mask;
+    }
+
+    step += HASH_MAP_GROUP;
+    pos = (pos + step) & mask;
+  }
+}
+
+u64 _HashMap_hash(const HashMap* map, const void* key) {
+  return map->_hash ? map->_hash(key) :
+         Hash_bytes(key, map->_keySize, HASH_DEFAULT_SEED);
+}
+
+void* _HashMap_keyAt(const HashMap* map, size_t index) {
+  return map->_slots + index * map->_slotSize;
+}
+
+/**
+ * Moves every entry into a fresh table of [capacity] slots, dropping the
+ * tombstones. Entries are moved bitwise. On error the map is left as it was.
+ * @error  S_E_NOMEMS
+ */
+void _HashMap_rehash(HashMap* map, size_t capacity, SystemErrNoMems* se) {
+  u8* oldCtrl = map->_ctrl;
+  char* oldSlots = map->_slots;
+  size_t oldCapacity = map->_capacity;
+  size_t i;
+  u8* ctrl = (u8*) malloc(capacity + HASH_MAP_GROUP);
+  char* slots = (char*) malloc(capacity * map->_slotSize);
+  if (ctrl == NULL || slots == NULL) {
+    free(ctrl);
+    free(slots);
+    se->any = true;
+    sprintf(se->msg, "HashMap rehash: No more memory available");
+    return;
+  }
+
+  // The control bytes and the slots count as one table. Entries are rehashed
+  // one at a time rather than copied as a block, so it's not counted as moved.
+  if (oldCtrl) {
+    AllocStats_recordResize(ALLOC_KIND_HASH_MAP,
+                            oldCapacity * (1 + map->_slotSize) + HASH_MAP_GROUP,
+                            capacity * (1 + map->_slotSize) + HASH_MAP_GROUP,
+                            false);
+  } else {
+    AllocStats_recordAlloc(ALLOC_KIND_HASH_MAP,
+                           capacity * (1 + map->_slotSize) + HASH_MAP_GROUP);
+  }
+
+  memset(ctrl, _HASH_MAP_EMPTY, capacity + HASH_MAP_GROUP);
+  map->_ctrl = ctrl;
+  map->_slots = slots;
+  map->_capacity = capacity;
+  map->_growthLeft = _HASH_MAP_MAX_LOAD(capacity) - map->length;
+  for (i = 0; i < oldCapacity; ++i) {
+    if (!(oldCtrl[i] & _HASH_MAP_EMPTY)) {
+      const char* slot = oldSlots + i * map->_slotSize;
+      u64 hash = _HashMap_hash(map, slot);
+      size_t to = _HashMap_findInsertSlot(map, hash);
+      _HashMap_setCtrl(map, to, _HASH_MAP_H2(hash));
+      memcpy(_HashMap_keyAt(map, to), slot, map->_slotSize);
+    }
+  }
+
+  free(oldCtrl);
+  free(oldSlots);
+}
+
+/**
+ * The first group's control bytes are mirrored past the end so a group can
+ * be loaded starting at any slot without wrapping.
+ */
+void _HashMap_setCtrl(HashMap* map, size_t index, u8 ctrl) {
+  map->_ctrl[index] = ctrl;
+  if (index < HASH_MAP_GROUP) {
+    map->_ctrl[map->_capacity + index] = ctrl;
+  }
+}
+
+
+/**
+ * Bit i is set when byte i of the [group] is [ctrl].
+ */
+static u32 _HashMap_matchByte(const u8* group, u8 ctrl) {
+#if defined(__SSE2__)
+  __m128i bytes = _mm_loadu_si128((const __m128i*) group);
+  return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char) ctrl)));
+#else
+  u32 matches = 0;
+  int i;
+  for (i = 0; i < HASH_MAP_GROUP; ++i) {
+    matches |= (u32) (group[i] == ctrl) << i;
+  }
+  return matches;
+#endif
+}
+
+/**
+ * Empty and deleted are the only control bytes with the high bit set.
+ */
+static u32 _HashMap_matchEmptyOrDeleted(const u8* group) {
+#if defined(__SSE2__)
+  return (u32) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) group));
+#else
+  u32 matches = 0;
+  int i;
+  for (i = 0; i < HASH_MAP_GROUP; ++i) {
+    matches |= (u32) (group[i] >> 7) << i;
+  }
+  return matches;
+#endif
+}
+
+/**
+ * The largest power of two dividing [size], up to 16.
+ */
+static size_t _HashMap_alignOf(size_t size) {
+  size_t align = 1;
+  while (align < 16 && size % (align * 2) == 0 && size) {
+    align *= 2;
+  }
+  return align;
+}
+
+static u64 _HashMap_hashString(const void* str) {
+  return String_hash((const String*) str);
+}
+
+static bool _HashMap_equalsString(const void* str, const void* otherStr) {
+  return String_equals((const String*) str, (const String*) otherStr);
+}
+
+static bool _HashMap_equalsView(const void* view, const void* str) {
+  StringView strView;
+  return StringView_equals((const StringView*) view,
+                           String_view((const String*) str, &strView));
+}
+
+/**
+ * Keys always go on the global allocator, whatever the String they were
+ * copied from used, since the map may well outlive it.
+ */
+static void* _HashMap_copyString(void* str, const void* copyStr, Err* se) {
+  const String* copy = (const String*) copyStr;
+  return initStringN((String*) str, (const char*) copy->arr, copy->length, se);
+}
+
+static void _HashMap_deinitString(void* str) {
+  deinitString((String*) str);
+}
+
+#endif
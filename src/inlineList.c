@@ -0,0 +1,225 @@
+#include "inlineList.h"
+
+#ifndef __BCC__
+
+#include "stdlib.h"
+#include "string.h"
+
+InlineNode* _InlineList_newNode(InlineList* list, const void* data, SystemErr* se);
+void _InlineList_linkLast(InlineList* list, InlineNode* node);
+void _InlineList_releaseNode(InlineList* list, InlineNode* node);
+
+InlineList* initInlineList(InlineList* list, size_t typeSize,
+                           void* (*copyInitializer)(void*, const void*, SystemErr*),
+                           void (*deInitializer)(void*)) {
+  return initInlineListPooled(list, typeSize, copyInitializer, deInitializer,
+                              NULL);
+}
+
+InlineList* initInlineListCp(InlineList* list, const InlineList* copy,
+                             SystemErr* se) {
+  InlineNode* nextNode = copy->firstNode;
+  initInlineListPooled(list, copy->_typeSize, copy->_copyInitializer,
+                       copy->_deInitializer, copy->_pool);
+  while (nextNode != NULL && !*se) {
+    InlineList_append(list, nextNode->data, se);
+    nextNode = nextNode->next;
+  }
+
+  return list;
+}
+
+/**
+ * Like initInlineList() but nodes come out of [pool], which must have been
+ * initialized with a slot size of at least InlineList_nodeSize([typeSize]).
+ */
+InlineList* initInlineListPooled(InlineList* list, size_t typeSize,
+                                 void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                 void (*deInitializer)(void*), NodePool* pool) {
+  list->firstNode = NULL;
+  list->lastNode = NULL;
+  list->length = 0;
+  list->_copyInitializer = copyInitializer;
+  list->_deInitializer = deInitializer;
+  list->_typeSize = typeSize;
+  list->_pool = pool;
+  return list;
+}
+
+void deinitInlineList(InlineList* list) {
+  InlineList_clear(list);
+}
+
+
+void InlineList_append(InlineList* list, const void* data, SystemErr* se) {
+  InlineNode* lastNode = _InlineList_newNode(list, data, se);
+  if (lastNode != NULL) {
+    _InlineList_linkLast(list, lastNode);
+  }
+}
+
+/**
+ * Appends a zeroed element and returns it to be initialized.
+ * @error  S_E_NOMEMS
+ */
+void* InlineList_appendEmpty(InlineList* list, SystemErr* se) {
+  InlineNode* lastNode = _InlineList_newNode(list, NULL, se);
+  if (lastNode == NULL) {
+    return NULL;
+  }
+
+  _InlineList_linkLast(list, lastNode);
+  return lastNode->data;
+}
+
+void InlineList_prepend(InlineList* list, const void* data, SystemErr* se) {
+  InlineNode* firstNode = _InlineList_newNode(list, data, se);
+  if (firstNode == NULL) {
+    return;
+  }
+
+  firstNode->next = list->firstNode;
+  list->firstNode = firstNode;
+  if (list->lastNode == NULL) {
+    list->lastNode = firstNode;
+  }
+  list->length++;
+}
+
+
+void* InlineList_first(const InlineList* list) {
+  return list->firstNode->data;
+}
+
+void* InlineList_last(const InlineList* list) {
+  return list->lastNode->data;
+}
+
+void InlineList_clear(InlineList* list) {
+  InlineNode* nextNode = list->firstNode;
+  while (nextNode != NULL) {
+    InlineNode* tmp = nextNode->next;
+    _InlineList_releaseNode(list, nextNode);
+    nextNode = tmp;
+  }
+
+  list->length = 0;
+  list->firstNode = NULL;
+  list->lastNode = NULL;
+}
+
+
+void InlineList_removeFirst(InlineList* list) {
+  InlineNode* oldFirst = list->firstNode;
+  list->firstNode = oldFirst->next;
+  if (list->firstNode == NULL) {
+    list->lastNode = NULL;
+  }
+
+  _InlineList_releaseNode(list, oldFirst);
+  list->length--;
+}
+
+/**
+ * Has to walk the list to find the new last node.
+ */
+void InlineList_removeLast(InlineList* list) {
+  InlineNode* lastNode = list->lastNode;
+  if (list->firstNode != lastNode) {
+    InlineNode* nextToLast = list->firstNode;
+    while (nextToLast->next != lastNode) {
+      nextToLast = nextToLast->next;
+    }
+    nextToLast->next = NULL;
+    list->lastNode = nextToLast;
+  } else {
+    list->firstNode = NULL;
+    list->lastNode = NULL;
+  }
+
+  _InlineList_releaseNode(list, lastNode);
+  list->length--;
+}
+
+/**
+ * Finds an item in the list with the given comparison function.
+ * @errors LL_E_NOT_FOUND
+ */
+void* InlineList_find(InlineList* list, void* dataToFind,
+                      bool (*cmp)(void* dataToFind, void* itemData), LLErr* le) {
+  InlineNode* node = list->firstNode;
+  while (node != NULL) {
+    if (cmp(dataToFind, node->data)) {
+      return node->data;
+    }
+
+    node = node->next;
+  }
+
+  *le = LL_E_NOT_FOUND;
+
+  return NULL;
+}
+
+/**
+ * Bytes taken by one node holding an element of [typeSize] bytes. Also the
+ * slot size a NodePool needs to serve the list.
+ */
+size_t InlineList_nodeSize(size_t typeSize) {
+  return offsetof(InlineNode, data) + typeSize;
+}
+
+/**
+ * Allocates a node and copies [data] into it, or zeroes it if [data] is NULL.
+ * @error  S_E_NOMEMS
+ */
+InlineNode* _InlineList_newNode(InlineList* list, const void* data,
+                                SystemErr* se) {
+  InlineNode* node;
+  if (list->_pool) {
+    node = (InlineNode*) NodePool_alloc(list->_pool, se);
+  } else {
+    node = (InlineNode*) malloc(InlineList_nodeSize(list->_typeSize));
+    if (node == NULL) {
+      *se = S_E_NOMEMS;
+    }
+  }
+
+  if (node != NULL) {
+    node->next = NULL;
+    if (data == NULL) {
+      memset(node->data, 0, list->_typeSize);
+    } else if (list->_copyInitializer) {
+      memset(node->data, 0, list->_typeSize);
+      list->_copyInitializer(node->data, data, se);
+    } else {
+      memcpy(node->data, data, list->_typeSize);
+    }
+  }
+
+  return node;
+}
+
+void _InlineList_linkLast(InlineList* list, InlineNode* node) {
+  if (list->firstNode == NULL) {
+    list->firstNode = node;
+  } else {
+    list->lastNode->next = node;
+  }
+  list->lastNode = node;
+  list->length++;
+}
+
+void _InlineList_releaseNode(InlineList* list, InlineNode* node) {
+  if (list->_deInitializer) {
+    list->_deInitializer(node->data);
+  }
+
+  if (list->_pool) {
+    NodePool_free(list->_pool, node);
+  } else {
+    free(node);
+  }
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "lineReader.h"
+
+#ifndef __BCC__
+
+#include "string.h"
+
+#include "byteScan.h"
+
+/**
+ * [bufSize] is how many bytes are read at a time, 0 for
+ * LINE_READER_DEFAULT_BUF_SIZE. The buffer grows if a line doesn't fit.
+ * @error  S_E_NOMEMS
+ */
+LineReader* initLineReader(LineReader* reader, FILE* file, size_t bufSize,
+                           SystemErrNoMems* se) {
+  reader->file = file;
+  reader->_start = 0;
+  reader->_scanned = 0;
+  reader->_eof = false;
+  bufSize = bufSize ? bufSize : LINE_READER_DEFAULT_BUF_SIZE;
+  initByteVector(&reader->buffer, bufSize + 1, NULL, 0, se);
+  return reader;
+}
+
+/**
+ * The FILE isn't closed.
+ */
+void deinitLineReader(LineReader* reader) {
+  deinitString(&reader->buffer);
+}
+
+/**
+ * Points [line] at the next line, without its '\n'. The last line doesn't
+ * need a '\n' at the end. [line] stays valid until the next call.
+ * @return  false once there are no more lines.
+ * @error   Err when reading fails, S_E_NOMEMS
+ */
+bool LineReader_next(LineReader* reader, StringView* line, Err* e) {
+  String* buffer = &reader->buffer;
+  while (!e->any) {
+    char* start = (char*) buffer->arr + reader->_start;
+    size_t available = buffer->length - reader->_start;
+    size_t newline = reader->_scanned +
+      ByteScan_findChar(start + reader->_scanned, available - reader->_scanned, '\n');
+
+    if (newline < available) {
+      initStringView(line, start, newline);
+      reader->_start += newline + 1;
+      reader->_scanned = 0;
+      return true;
+    } else if (reader->_eof) {
+      if (available == 0) {
+        return false;
+      }
+
+      initStringView(line, start, available);
+      reader->_start = buffer->length;
+      reader->_scanned = 0;
+      return true;
+    }
+
+    reader->_scanned = available;
+    _LineReader_fill(reader, e);
+  }
+
+  return false;
+}
+
+/**
+ * Moves the unfinished line to the front of the buffer and reads another
+ * block after it. The buffer doubles if the unfinished line fills it.
+ * @error  Err when reading fails, S_E_NOMEMS
+ */
+void _LineReader_fill(LineReader* reader, Err* e) {
+  String* buffer = &reader->buffer;
+  size_t read;
+  if (reader->_start > 0) {
+    buffer->length -= reader->_start;
+    memmove(buffer->arr, (char*) buffer->arr + reader->_start, buffer->length);
+    reader->_start = 0;
+  }
+
+  if (buffer->length + 1 >= buffer->_arrSize) {
+    Vector_reserve(buffer, buffer->_arrSize * 2, e);
+    if (e->any) {
+      return;
+    }
+  }
+
+  read = fread((char*) buffer->arr + buffer->length, 1,
+               buffer->_arrSize - 1 - buffer->length, reader->file);
+  buffer->length += read;
+  _Vector_appendNull(buffer);
+  if (read == 0) {
+    reader->_eof = true;
+    if (ferror(reader->file)) {
+      e->any = true;
+      sprintf(e->msg, "LineReader: Failed reading file");
+    }
+  }
+}
+
+#endif
@@ -2,25 +2,37 @@
 
 #ifndef __BCC__
 
+#include "allocStats.h"
 #include "stdlib.h"
 #include "string.h"
 
-void _LinkedList_generateLastNode(LinkedList* list);
+// Pooled node data is stored right after the node, kept aligned
+#define _LINKED_LIST_POOLED_DATA_OFFSET \
+  ((sizeof(SingleLinkedNode) + NODE_POOL_ALIGN - 1) / NODE_POOL_ALIGN * NODE_POOL_ALIGN)
+
+void _LinkedList_copyInto(LinkedList* list, void* nodeData, const void* data,
+                          SystemErr* se);
+SingleLinkedNode* _LinkedList_newNode(LinkedList* list, SystemErr* se);
+void _LinkedList_releaseNode(LinkedList* list, SingleLinkedNode* node);
 
 LinkedList* initLinkedList(LinkedList* list, size_t typeSize,
                            void* (*copyInitializer)(void*, const void*, SystemErr*),
                            void (*deInitializer)(void*)) {
   list->firstNode = NULL;
   list->lastNode = NULL;
+  list->length = 0;
   list->_copyInitializer = copyInitializer;
   list->_deInitializer = deInitializer;
   list->_typeSize = typeSize;
+  list->_pool = NULL;
+  list->_allocator = NULL;
   return list;
 }
 
 LinkedList* initLinkedListCp(LinkedList* list, const LinkedList* copy, SystemErr* se) {
-  initLinkedList(list, copy->_typeSize, copy->_copyInitializer,
-                 copy->_deInitializer);
+  initLinkedListPooled(list, copy->_typeSize, copy->_copyInitializer,
+                       copy->_deInitializer, copy->_pool);
+  list->_allocator = copy->_allocator;
   SingleLinkedNode* nextNode = copy->firstNode;
   while (nextNode != NULL) {
     LinkedList_append(list, nextNode->data, se);
@@ -31,6 +43,39 @@ LinkedList* initLinkedListCp(LinkedList* list, const LinkedList* copy, SystemErr
 }
 
 
+/**
+ * Same as initLinkedList() but every node comes out of [pool] with its data
+ * stored inline after it, so adding an element is a single pool allocation
+ * instead of two mallocs. [pool] may be shared between lists and must have
+ * been initialized with a slot size of at least
+ * LinkedList_poolSlotSize([typeSize]). NULL gives a regular list.
+ */
+LinkedList* initLinkedListPooled(LinkedList* list, size_t typeSize,
+                                 void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                 void (*deInitializer)(void*), NodePool* pool) {
+  initLinkedList(list, typeSize, copyInitializer, deInitializer);
+  list->_pool = pool;
+  return list;
+}
+
+/**
+ * Same as initLinkedList() but each node and its data are one allocation
+ * from [allocator], laid out like pooled nodes. NULL gives a regular list.
+ * [allocator] must outlive the list.
+ */
+LinkedList* initLinkedListWithAllocator(LinkedList* list, size_t typeSize,
+                                        void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                        void (*deInitializer)(void*),
+                                        const Allocator* allocator) {
+  initLinkedList(list, typeSize, copyInitializer, deInitializer);
+  list->_allocator = allocator;
+  return list;
+}
+
+/**
+ * Empties the list. A pool the list was given is left alone since it may be
+ * shared.
+ */
 void deinitLinkedList(LinkedList* list) {
   LinkedList_clear(list);
 }
@@ -63,6 +108,10 @@ SingleLinkedNode* initSingleLinkedNode_empty(SingleLinkedNode* node,
   return node;
 }
 
+/**
+ * Deinitializes the node's data and frees the memory
+ * initSingleLinkedNode_empty() allocated for it.
+ */
 void deinitSingleLinkedNode(SingleLinkedNode* node, size_t typeSize,
                             void (*deInitializer)(void*)) {
   if (deInitializer) {
@@ -70,24 +119,28 @@ void deinitSingleLinkedNode(SingleLinkedNode* node, size_t typeSize,
   } else {
     memset(node->data, 0, typeSize);
   }
+  free(node->data);
+  node->data = NULL;
 }
 
 void LinkedList_append(LinkedList* list, const void* data, SystemErr* se) {
-  _LinkedList_generateLastNode(list);
-  initSingleLinkedNode(list->lastNode, data, list->_typeSize,
-                       list->_copyInitializer, se);
+  void* nodeData = LinkedList_appendEmpty(list, se);
+  if (nodeData != NULL) {
+    _LinkedList_copyInto(list, nodeData, data, se);
+  }
 }
 
+/**
+ * Appends a node with zeroed data and returns the data to be initialized.
+ * @error  S_E_NOMEMS
+ */
 void* LinkedList_appendEmpty(LinkedList* list, SystemErr* se) {
-  _LinkedList_generateLastNode(list);
-  initSingleLinkedNode_empty(list->lastNode, list->_typeSize, se);
-  return list->lastNode->data;
-}
+  SingleLinkedNode* lastNode = _LinkedList_newNode(list, se);
+  if (lastNode == NULL) {
+    return NULL;
+  }
 
-void _LinkedList_generateLastNode(LinkedList* list) {
-  SingleLinkedNode* lastNode = (SingleLinkedNode*) malloc(sizeof(SingleLinkedNode));
   list->length++;
-
   if (list->firstNode == NULL) {
     list->firstNode = lastNode;
   } else {
@@ -95,6 +148,7 @@ void _LinkedList_generateLastNode(LinkedList* list) {
   }
 
   list->lastNode = lastNode;
+  return lastNode->data;
 }
 
 
@@ -102,8 +156,7 @@ void LinkedList_clear(LinkedList* list) {
   SingleLinkedNode* nextNode = list->firstNode;
   while (nextNode != NULL) {
     SingleLinkedNode* tmp = nextNode->next;
-    deinitSingleLinkedNode(nextNode, list->_typeSize, list->_deInitializer);
-    free(nextNode);
+    _LinkedList_releaseNode(list, nextNode);
     nextNode = tmp;
   }
 
@@ -122,12 +175,16 @@ void* LinkedList_last(const LinkedList* list) {
 }
 
 void LinkedList_prepend(LinkedList* list, const void* data, SystemErr* se) {
-  SingleLinkedNode* oldFirst = list->firstNode;
-  list->firstNode = malloc(sizeof(SingleLinkedNode));
-  initSingleLinkedNode(list->firstNode, data, list->_typeSize,
-                       list->_copyInitializer, se);
-  if (oldFirst != NULL) {
-    list->firstNode->next = oldFirst;
+  SingleLinkedNode* newFirst = _LinkedList_newNode(list, se);
+  if (newFirst == NULL) {
+    return;
+  }
+
+  _LinkedList_copyInto(list, newFirst->data, data, se);
+  newFirst->next = list->firstNode;
+  list->firstNode = newFirst;
+  if (list->lastNode == NULL) {
+    list->lastNode = newFirst;
   }
   list->length++;
 }
@@ -141,8 +198,7 @@ void LinkedList_removeFirst(LinkedList* list) {
     list->firstNode = NULL;
     list->lastNode = NULL;
   }
-  deinitSingleLinkedNode(oldFirst, list->_typeSize, list->_deInitializer);
-  free(oldFirst);
+  _LinkedList_releaseNode(list, oldFirst);
   list->length--;
 }
 
@@ -160,8 +216,7 @@ void LinkedList_removeLast(LinkedList* list) {
     list->lastNode = NULL;
   }
 
-  deinitSingleLinkedNode(lastNode, list->_typeSize, list->_deInitializer);
-  free(lastNode);
+  _LinkedList_releaseNode(list, lastNode);
   list->length--;
 }
 
@@ -185,4 +240,94 @@ void* LinkedList_find(LinkedList* list, void* dataToFind,
   return NULL;
 }
 
+/**
+ * The slot size a NodePool needs to serve the nodes of a list holding
+ * elements of [typeSize] bytes.
+ */
+size_t LinkedList_poolSlotSize(size_t typeSize) {
+  return _LINKED_LIST_POOLED_DATA_OFFSET + typeSize;
+}
+
+void _LinkedList_copyInto(LinkedList* list, void* nodeData, const void* data,
+                          SystemErr* se) {
+  if (list->_copyInitializer) {
+    list->_copyInitializer(nodeData, data, se);
+  } else {
+    memcpy(nodeData, data, list->_typeSize);
+  }
+}
+
+/**
+ * Allocates a node with zeroed data, from the list's pool or allocator if it
+ * has one.
+ * @error  S_E_NOMEMS
+ */
+SingleLinkedNode* _LinkedList_newNode(LinkedList* list, SystemErr* se) {
+  SingleLinkedNode* node;
+  if (list->_pool || list->_allocator) {
+    if (list->_pool) {
+      node = (SingleLinkedNode*) NodePool_alloc(list->_pool, se);
+    } else {
+      node = (SingleLinkedNode*) Allocator_alloc(
+        list->_allocator, LinkedList_poolSlotSize(list->_typeSize));
+      if (node == NULL) {
+        *se = S_E_NOMEMS;
+      } else {
+        AllocStats_recordAlloc(ALLOC_KIND_LINKED_LIST,
+                               LinkedList_poolSlotSize(list->_typeSize));
+      }
+    }
+
+    if (node != NULL) {
+      node->next = NULL;
+      node->data = (char*) node + _LINKED_LIST_POOLED_DATA_OFFSET;
+      memset(node->data, 0, list->_typeSize);
+    }
+    return node;
+  }
+
+  node = (SingleLinkedNode*) malloc(sizeof(SingleLinkedNode));
+  if (node == NULL) {
+    *se = S_E_NOMEMS;
+    return NULL;
+  }
+
+  initSingleLinkedNode_empty(node, list->_typeSize, se);
+  if (node->data == NULL) {
+    free(node);
+    return NULL;
+  }
+
+  // The node and its data count as one allocation, like a pooled node
+  AllocStats_recordAlloc(ALLOC_KIND_LINKED_LIST,
+                         sizeof(SingleLinkedNode) + list->_typeSize);
+  return node;
+}
+
+/**
+ * Deinitializes a node's data and frees the node, the opposite of
+ * _LinkedList_newNode().
+ */
+void _LinkedList_releaseNode(LinkedList* list, SingleLinkedNode* node) {
+  if (list->_pool || list->_allocator) {
+    if (list->_deInitializer) {
+      list->_deInitializer(node->data);
+    }
+
+    if (list->_pool) {
+      NodePool_free(list->_pool, node);
+    } else {
+      Allocator_release(list->_allocator, node,
+                        LinkedList_poolSlotSize(list->_typeSize));
+      AllocStats_recordRelease(ALLOC_KIND_LINKED_LIST,
+                               LinkedList_poolSlotSize(list->_typeSize));
+    }
+  } else {
+    deinitSingleLinkedNode(node, list->_typeSize, list->_deInitializer);
+    free(node);
+    AllocStats_recordRelease(ALLOC_KIND_LINKED_LIST,
+                             sizeof(SingleLinkedNode) + list->_typeSize);
+  }
+}
+
 #endif
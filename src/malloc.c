@@ -1,108 +1,362 @@
 #include "malloc.h"
 
+#include "stdio.h"
+#include "string.h"
+
 #include "systemError.h"
 
-char buf[MALLOC_BUF_SIZE];
-bool initialized = false;
-size_t totalBytesAvailable = MALLOC_BUF_SIZE - sizeof(MemRecord);
+#define _MEM_USED ((size_t) 1)      // The block is allocated
+#define _MEM_PREV_USED ((size_t) 2) // The block right before it is allocated
+#define _MEM_FLAGS (_MEM_USED | _MEM_PREV_USED)
 
+// Payloads are aligned to _MEM_ALIGN and every block size is a multiple of it
+#define _MEM_ALIGN (2 * sizeof(size_t))
+#define _MEM_HEADER sizeof(size_t)
+#define _MEM_MIN_BLOCK \
+  ((sizeof(MemRecord) + sizeof(size_t) + _MEM_ALIGN - 1) / _MEM_ALIGN * _MEM_ALIGN)
 
-void* malloc(size_t size) {
-  MemRecord* recordIter;
-  MemRecord* new = NULL;
-  bool spaceAvailableAfter;
-  if (!initialized) {
-    initMemRecordRoot();
+#define _MEM_SIZE(m) ((m)->size & ~_MEM_FLAGS)
+#define _MEM_PAYLOAD(m) ((char*) (m) + _MEM_HEADER)
+#define _MEM_RECORD(ptr) ((MemRecord*) ((char*) (ptr) - _MEM_HEADER))
+
+static char buf[MALLOC_BUF_SIZE];
+static char* arenaStart = NULL;
+static char* arenaEnd = NULL;
+static MemRecord* freeLists[MALLOC_SIZE_CLASSES];
+static unsigned int nonEmptyClasses = 0; // Bit c is set when freeLists[c] isn't empty
+static size_t totalBytesAvailable = 0;
+
+
+/**
+ * Starts over with the whole buffer as one free block. Anything allocated
+ * before is forgotten. Called on the first allocation.
+ */
+void initMemBuf() {
+  MemRecord* m;
+  size_t c;
+  arenaStart = buf;
+  while ((size_t) (arenaStart + _MEM_HEADER) % _MEM_ALIGN) {
+    ++arenaStart;
   }
+  arenaEnd = arenaStart +
+    (size_t) (buf + MALLOC_BUF_SIZE - arenaStart) / _MEM_ALIGN * _MEM_ALIGN;
 
-  recordIter = (MemRecord*) buf;
-  spaceAvailableAfter = MemRecord_isSpaceAvailableAfter(recordIter, size);
-  while (recordIter->next != NULL && !spaceAvailableAfter) {
-    recordIter = recordIter->next;
-    spaceAvailableAfter = MemRecord_isSpaceAvailableAfter(recordIter, size);
+  for (c = 0; c < MALLOC_SIZE_CLASSES; ++c) {
+    freeLists[c] = NULL;
   }
+  nonEmptyClasses = 0;
+  totalBytesAvailable = (size_t) (arenaEnd - arenaStart);
 
-  if (spaceAvailableAfter) {
-    new = MemRecord_allocateAfter(recordIter, size);
-  } else {
-    putc('\n');
-    printf("Failed to allocate %u bytes. %uB total available\n", size, totalBytesAvailable);
+  m = (MemRecord*) arenaStart;
+  m->size = _MEM_PREV_USED; // Nothing before the first block can be merged
+  _MemBuf_setFree(m, (size_t) (arenaEnd - arenaStart));
+  _MemBuf_link(m);
+}
+
+void* MemBuf_malloc(size_t size) {
+  MemRecord* m;
+  size_t needed = (size + _MEM_HEADER + _MEM_ALIGN - 1) / _MEM_ALIGN * _MEM_ALIGN;
+  if (arenaStart == NULL) {
+    initMemBuf();
+  }
+
+  needed = needed < _MEM_MIN_BLOCK ? _MEM_MIN_BLOCK : needed;
+  m = needed > size ? _MemBuf_findFree(needed) : NULL;
+  if (m == NULL) {
+#ifdef MALLOC_TRACE
+#if __BCC__
+    printf("Failed to allocate %u bytes. %uB total available\n", size,
+           totalBytesAvailable);
+#else
+    printf("Failed to allocate %lu bytes. %luB total available\n",
+           (unsigned long) size, (unsigned long) totalBytesAvailable);
+#endif
+#endif
     return NULL;
   }
 
-  totalBytesAvailable -= new->len + sizeof(MemRecord);
-  printf("Allocated %u+ %uB @ %x. %uB available\n", 
-    new->len, sizeof(MemRecord), new + 1, totalBytesAvailable);
-  return new + 1;
+  _MemBuf_unlink(m);
+  _MemBuf_split(m, needed);
+  m->size |= _MEM_USED;
+  if ((char*) _MemBuf_nextRecord(m) < arenaEnd) {
+    _MemBuf_nextRecord(m)->size |= _MEM_PREV_USED;
+  }
+
+  totalBytesAvailable -= _MEM_SIZE(m);
+#ifdef MALLOC_TRACE
+#if __BCC__
+  printf("Allocated %uB @ %x. %uB available\n", _MEM_SIZE(m), _MEM_PAYLOAD(m),
+         totalBytesAvailable);
+#else
+  printf("Allocated %luB @ %p. %luB available\n", (unsigned long) _MEM_SIZE(m),
+         (void*) _MEM_PAYLOAD(m), (unsigned long) totalBytesAvailable);
+#endif
+#endif
+  return _MEM_PAYLOAD(m);
 }
 
-void* realloc(void* old, size_t size) {
+/**
+ * Resizes in place whenever it can: shrinking gives the tail back, and
+ * growing takes over the free block right after, if that's enough. Only
+ * otherwise is the block moved.
+ */
+void* MemBuf_realloc(void* old, size_t size) {
   void* new;
+  size_t oldSize;
+  size_t needed = (size + _MEM_HEADER + _MEM_ALIGN - 1) / _MEM_ALIGN * _MEM_ALIGN;
+#ifdef MALLOC_TRACE
   printf("Reallocating: ");
-  new = malloc(size);
+#endif
+  if (old == NULL) {
+    return MemBuf_malloc(size);
+  }
+
+  needed = needed < _MEM_MIN_BLOCK ? _MEM_MIN_BLOCK : needed;
+  if (needed > size && _MemBuf_resizeInPlace(_MEM_RECORD(old), needed)) {
+#ifdef MALLOC_TRACE
+#if __BCC__
+    printf("Resized in place to %uB @ %x. %uB available\n",
+           _MEM_SIZE(_MEM_RECORD(old)), old, totalBytesAvailable);
+#else
+    printf("Resized in place to %luB @ %p. %luB available\n",
+           (unsigned long) _MEM_SIZE(_MEM_RECORD(old)), old,
+           (unsigned long) totalBytesAvailable);
+#endif
+#endif
+    return old;
+  }
+
+  new = MemBuf_malloc(size);
   if (!new) {
     return NULL;
   }
 
-  memcpy(new, old, ((MemRecord*) ((char*) old - sizeof(MemRecord)))->len);
-  free(old);
+  oldSize = _MEM_SIZE(_MEM_RECORD(old)) - _MEM_HEADER;
+  memcpy(new, old, oldSize < size ? oldSize : size);
+  MemBuf_free(old);
   return new;
 }
 
-void free(void* ptr) {
+/**
+ * Gives the block back, merging it with a free block on either side.
+ */
+void MemBuf_free(void* ptr) {
   Err e;
-  MemRecord* m = MemRecord_findPreviousRecordFor((MemRecord*) buf, ptr);
-  if (!m) {
+  MemRecord* m = _MEM_RECORD(ptr);
+  MemRecord* next;
+  size_t size;
+  if (ptr == NULL) {
+    return;
+  }
+
+  if ((char*) m < arenaStart || (char*) m >= arenaEnd || !(m->size & _MEM_USED)) {
     e.any = true;
+#if __BCC__
     sprintf(e.msg, "Invalid ptr to free @ %x", ptr);
+#else
+    sprintf(e.msg, "Invalid ptr to free @ %p", ptr);
+#endif
     raiseError(&e);
+    return;
   }
 
-  totalBytesAvailable += m->next->len + sizeof(MemRecord);
-  printf("Freed %u+ %uB @ %x. %uB available\n",
-    m->next->len, sizeof(MemRecord), ptr,
-    totalBytesAvailable);
-  MemRecord_deallocateAfter(m);
+  size = _MEM_SIZE(m);
+  totalBytesAvailable += size;
+#ifdef MALLOC_TRACE
+#if __BCC__
+  printf("Freed %uB @ %x. %uB available\n", size, ptr, totalBytesAvailable);
+#else
+  printf("Freed %luB @ %p. %luB available\n", (unsigned long) size, ptr,
+         (unsigned long) totalBytesAvailable);
+#endif
+#endif
+
+  next = _MemBuf_nextRecord(m);
+  if ((char*) next < arenaEnd && !(next->size & _MEM_USED)) {
+    _MemBuf_unlink(next);
+    size += _MEM_SIZE(next);
+  }
+
+  if (!(m->size & _MEM_PREV_USED)) {
+    // A free block before this one ends with its size
+    MemRecord* prev = (MemRecord*) ((char*) m - *((size_t*) m - 1));
+    _MemBuf_unlink(prev);
+    size += _MEM_SIZE(prev);
+    m = prev;
+  }
+
+  m->size &= _MEM_PREV_USED;
+  _MemBuf_setFree(m, size);
+  _MemBuf_link(m);
 }
 
-void initMemRecord(MemRecord* m, size_t len) {
-  m->len = len;
-  m->next = NULL;
+/**
+ * Free bytes left in the buffer, block headers included.
+ */
+size_t MemBuf_available() {
+  if (arenaStart == NULL) {
+    initMemBuf();
+  }
+
+  return totalBytesAvailable;
 }
 
-void initMemRecordRoot() {
-  initMemRecord(buf, 0);
-  initialized = true;
+
+#if __BCC__
+void* malloc(size_t size) {
+  return MemBuf_malloc(size);
 }
 
+void* realloc(void* old, size_t size) {
+  return MemBuf_realloc(old, size);
+}
 
-bool MemRecord_isSpaceAvailableAfter(MemRecord* record, size_t requestSize) {
-  size_t requestedEnd = (char*) (record + 1) + record->len + requestSize + sizeof(MemRecord);
-  return (record->next == NULL && requestedEnd <= buf + MALLOC_BUF_SIZE) ||
-    (record->next != NULL && requestedEnd <= record->next);
+void free(void* ptr) {
+  MemBuf_free(ptr);
 }
+#endif
 
-MemRecord* MemRecord_allocateAfter(MemRecord* m, size_t len) {
-  MemRecord* new = (char*) (m + 1) + m->len;
-  MemRecord* next = m->next;
-  initMemRecord(new, len);
-  m->next = new;
-  new->next = next;
-  return new;
+
+/**
+ * Class c holds free blocks of at least _MEM_MIN_BLOCK << c bytes. The last
+ * class takes everything bigger too.
+ */
+size_t _MemBuf_classOf(size_t size) {
+  size_t c = 0;
+  size /= _MEM_MIN_BLOCK;
+  while (size > 1 && c < MALLOC_SIZE_CLASSES - 1) {
+    size >>= 1;
+    ++c;
+  }
+  return c;
 }
 
-MemRecord* MemRecord_findPreviousRecordFor(MemRecord* m, void* ptr) {
-  while (m->next != NULL && m->next + 1 != ptr) {
-    m = m->next;
+/**
+ * Good fit in constant time. The head of [size]'s own class is taken if it's
+ * big enough, otherwise the smallest block of any bigger class, which always
+ * is. Only when there's none of those is the rest of the own class searched.
+ */
+MemRecord* _MemBuf_findFree(size_t size) {
+  size_t c = _MemBuf_classOf(size);
+  unsigned int bigger;
+  MemRecord* m = freeLists[c];
+  if (m != NULL && _MEM_SIZE(m) >= size) {
+    return m;
   }
 
-  if (m->next == NULL) {
-    return NULL;
+  bigger = nonEmptyClasses >> c >> 1;
+  if (bigger) {
+    ++c;
+    while (!(bigger & 1)) {
+      bigger >>= 1;
+      ++c;
+    }
+    return freeLists[c];
   }
 
+  while (m != NULL && _MEM_SIZE(m) < size) {
+    m = m->next;
+  }
   return m;
 }
 
-MemRecord* MemRecord_deallocateAfter(MemRecord* m) {
-  m->next = m->next->next;
+void _MemBuf_link(MemRecord* m) {
+  size_t c = _MemBuf_classOf(_MEM_SIZE(m));
+  m->prev = NULL;
+  m->next = freeLists[c];
+  if (m->next) {
+    m->next->prev = m;
+  }
+  freeLists[c] = m;
+  nonEmptyClasses |= 1u << c;
+}
+
+void _MemBuf_unlink(MemRecord* m) {
+  size_t c = _MemBuf_classOf(_MEM_SIZE(m));
+  if (m->prev) {
+    m->prev->next = m->next;
+  } else {
+    freeLists[c] = m->next;
+    if (freeLists[c] == NULL) {
+      nonEmptyClasses &= ~(1u << c);
+    }
+  }
+
+  if (m->next) {
+    m->next->prev = m->prev;
+  }
+}
+
+MemRecord* _MemBuf_nextRecord(MemRecord* m) {
+  return (MemRecord*) ((char*) m + _MEM_SIZE(m));
+}
+
+/**
+ * Marks [m] as a free block of [size] bytes, keeping its _MEM_PREV_USED
+ * flag, and writes the size at its end for the block after it.
+ */
+void _MemBuf_setFree(MemRecord* m, size_t size) {
+  MemRecord* next;
+  m->size = size | (m->size & _MEM_PREV_USED);
+  *(size_t*) ((char*) m + size - sizeof(size_t)) = size;
+  next = _MemBuf_nextRecord(m);
+  if ((char*) next < arenaEnd) {
+    next->size &= ~_MEM_PREV_USED;
+  }
+}
+
+/**
+ * Makes the allocated block [m] [size] bytes without moving it, if the free
+ * block after it leaves enough room. Whatever is left over past [size] is
+ * freed.
+ * @return  Whether [m] was resized
+ */
+bool _MemBuf_resizeInPlace(MemRecord* m, size_t size) {
+  MemRecord* next = _MemBuf_nextRecord(m);
+  MemRecord* rest;
+  size_t restSize;
+  if (size > _MEM_SIZE(m)) {
+    if ((char*) next >= arenaEnd || (next->size & _MEM_USED) ||
+        _MEM_SIZE(m) + _MEM_SIZE(next) < size) {
+      return false;
+    }
+
+    _MemBuf_unlink(next);
+    totalBytesAvailable -= _MEM_SIZE(next);
+    m->size += _MEM_SIZE(next);
+    next = _MemBuf_nextRecord(m);
+    if ((char*) next < arenaEnd) {
+      next->size |= _MEM_PREV_USED;
+    }
+  }
+
+  restSize = _MEM_SIZE(m) - size;
+  if (restSize >= _MEM_MIN_BLOCK) {
+    // Carve the tail off as an allocated block and free it, which merges it
+    // with anything free after it
+    m->size = size | (m->size & _MEM_FLAGS);
+    rest = _MemBuf_nextRecord(m);
+    rest->size = restSize | _MEM_USED | _MEM_PREV_USED;
+    MemBuf_free(_MEM_PAYLOAD(rest));
+  }
+
+  return true;
+}
+
+/**
+ * Trims the unlinked block [m] down to [size] bytes if what's left over is
+ * big enough to be a block of its own, which goes back on a free list.
+ */
+void _MemBuf_split(MemRecord* m, size_t size) {
+  MemRecord* rest;
+  size_t restSize = _MEM_SIZE(m) - size;
+  if (restSize < _MEM_MIN_BLOCK) {
+    return;
+  }
+
+  m->size = size | (m->size & _MEM_FLAGS);
+  rest = _MemBuf_nextRecord(m);
+  rest->size = _MEM_PREV_USED; // [m] is about to be
+  _MemBuf_setFree(rest, restSize);
+  _MemBuf_link(rest);
 }
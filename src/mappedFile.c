@@ -0,0 +1,102 @@
+#include "mappedFile.h"
+
+#ifndef __BCC__
+
+#include "allocStats.h"
+#include "errno.h"
+#include "fcntl.h"
+#include "stdio.h"
+#include "string.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "unistd.h"
+
+static const char _emptyFile[1] = "";
+
+static void _MappedFile_error(const char* what, const char* path,
+                              MappedFileErr* e) {
+  e->any = true;
+  snprintf(e->msg, E_MSG_MAX_LEN, "MappedFile: %s %s: %s", what, path,
+           strerror(errno));
+}
+
+/**
+ * Maps the file at [path]. An empty file gives an empty Vector.
+ * @error  MappedFileErr
+ */
+MappedFile* initMappedFile(MappedFile* file, const char* path, MappedFileErr* e) {
+  struct stat info;
+  void* mapping = (void*) _emptyFile;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    _MappedFile_error("Can't open", path, e);
+    return file;
+  }
+
+  if (fstat(fd, &info) < 0) {
+    _MappedFile_error("Can't stat", path, e);
+  } else if (info.st_size > 0) {
+    mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      _MappedFile_error("Can't map", path, e);
+    }
+  }
+  // The mapping outlives the descriptor
+  close(fd);
+
+  if (!e->any) {
+    file->bytes.arr = mapping;
+    file->bytes.length = info.st_size;
+    file->bytes._arrSize = info.st_size;
+    file->bytes._copyInitializer = NULL;
+    file->bytes._deInitializer = NULL;
+    file->bytes._typeSize = sizeof(char);
+    file->bytes._rangeCopyInitializer = NULL;
+    file->bytes._growthPolicy = NULL;
+    file->bytes._allocator = NULL;
+    file->bytes._allocKind = ALLOC_KIND_OTHER;
+  }
+
+  return file;
+}
+
+void deinitMappedFile(MappedFile* file) {
+  if (file->bytes.arr && file->bytes.arr != _emptyFile) {
+    munmap(file->bytes.arr, file->bytes.length);
+  }
+  file->bytes.arr = NULL;
+}
+
+/**
+ * Tells the kernel how the mapping is going to be read. Sequential reads of
+ * a big file benefit from MF_ADVICE_SEQUENTIAL, and MF_ADVICE_WILLNEED starts
+ * reading it in right away.
+ * @error  MappedFileErr
+ */
+void MappedFile_advise(MappedFile* file, MappedFileAdvice advice,
+                       MappedFileErr* e) {
+  static const int advices[] = {
+    MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED
+  };
+
+  if ((size_t) advice >= sizeof(advices) / sizeof(advices[0])) {
+    e->any = true;
+    snprintf(e->msg, E_MSG_MAX_LEN, "MappedFile: Unknown advice %d", advice);
+  } else if (file->bytes.length > 0 &&
+             madvise(file->bytes.arr, file->bytes.length,
+                     advices[advice]) < 0) {
+    e->any = true;
+    snprintf(e->msg, E_MSG_MAX_LEN, "MappedFile: madvise failed: %s",
+             strerror(errno));
+  }
+}
+
+/**
+ * A view of the whole file, e.g. to walk it line by line with
+ * StringView_popLine().
+ */
+StringView* MappedFile_view(const MappedFile* file, StringView* view) {
+  return initStringView(view, file->bytes.arr, file->bytes.length);
+}
+
+#endif
@@ -0,0 +1,83 @@
+#include "nodePool.h"
+
+#ifndef __BCC__
+
+#include "stdlib.h"
+
+#define _NODE_POOL_ROUND_UP(size) \
+  (((size) + NODE_POOL_ALIGN - 1) / NODE_POOL_ALIGN * NODE_POOL_ALIGN)
+
+// Room for the chunk's link to the next chunk, keeping slots aligned
+#define _NODE_POOL_CHUNK_HEADER _NODE_POOL_ROUND_UP(sizeof(void*))
+
+/**
+ * [slotSize] is rounded up so every slot is aligned for any type.
+ * [slotsPerChunk] is how many slots each chunk holds, 0 for
+ * NODE_POOL_DEFAULT_SLOTS_PER_CHUNK. Nothing is allocated until the first
+ * NodePool_alloc().
+ */
+NodePool* initNodePool(NodePool* pool, size_t slotSize, size_t slotsPerChunk) {
+  slotSize = slotSize < sizeof(void*) ? sizeof(void*) : slotSize;
+  pool->slotSize = _NODE_POOL_ROUND_UP(slotSize);
+  pool->slotsPerChunk = slotsPerChunk ? slotsPerChunk
+                                      : NODE_POOL_DEFAULT_SLOTS_PER_CHUNK;
+  pool->_freeSlots = NULL;
+  pool->_chunks = NULL;
+  pool->_bump = NULL;
+  pool->_bumpEnd = NULL;
+  return pool;
+}
+
+/**
+ * Frees every chunk. Any slots still handed out become invalid.
+ */
+void deinitNodePool(NodePool* pool) {
+  void* chunk = pool->_chunks;
+  while (chunk != NULL) {
+    void* next = *(void**) chunk;
+    free(chunk);
+    chunk = next;
+  }
+
+  initNodePool(pool, pool->slotSize, pool->slotsPerChunk);
+}
+
+/**
+ * Hands out an uninitialized slot of [pool]->slotSize bytes.
+ * @error  S_E_NOMEMS
+ */
+void* NodePool_alloc(NodePool* pool, SystemErr* se) {
+  void* slot = pool->_freeSlots;
+  if (slot != NULL) {
+    pool->_freeSlots = *(void**) slot;
+    return slot;
+  }
+
+  if (pool->_bump == pool->_bumpEnd) {
+    char* chunk = (char*) malloc(_NODE_POOL_CHUNK_HEADER +
+                                 pool->slotSize * pool->slotsPerChunk);
+    if (chunk == NULL) {
+      *se = S_E_NOMEMS;
+      return NULL;
+    }
+
+    *(void**) chunk = pool->_chunks;
+    pool->_chunks = chunk;
+    pool->_bump = chunk + _NODE_POOL_CHUNK_HEADER;
+    pool->_bumpEnd = pool->_bump + pool->slotSize * pool->slotsPerChunk;
+  }
+
+  slot = pool->_bump;
+  pool->_bump += pool->slotSize;
+  return slot;
+}
+
+/**
+ * Gives [slot] back to [pool] to be handed out again.
+ */
+void NodePool_free(NodePool* pool, void* slot) {
+  *(void**) slot = pool->_freeSlots;
+  pool->_freeSlots = slot;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include "ringBuffer.h"
+
+#ifndef __BCC__
+
+#include <string.h>
+
+#define _RING_SLOT(ring, pos) \
+  ((char*) (ring)->_buffer.arr + ((pos) & (ring)->_mask) * (ring)->_buffer._typeSize)
+
+/**
+ * @error  S_E_NOMEMS
+ */
+SpscRingBuffer* initSpscRingBuffer(SpscRingBuffer* ring, size_t typeSize,
+                                   size_t capacity, SystemErrNoMems* se) {
+  ring->capacity = _RingBuffer_roundCapacity(capacity);
+  ring->_mask = ring->capacity - 1;
+  ring->_tailCache = 0;
+  ring->_headCache = 0;
+  atomic_init(&ring->_head, 0);
+  atomic_init(&ring->_tail, 0);
+  initVectorAdvanced(&ring->_buffer, typeSize, ring->capacity, NULL, 0, NULL,
+                     NULL, se);
+  return ring;
+}
+
+void deinitSpscRingBuffer(SpscRingBuffer* ring) {
+  deinitVector(&ring->_buffer);
+}
+
+/**
+ * Producer side only.
+ * @return  false if the ring is full
+ */
+bool SpscRingBuffer_push(SpscRingBuffer* ring, const void* data) {
+  size_t tail = atomic_load_explicit(&ring->_tail, memory_order_relaxed);
+  if (tail - ring->_headCache == ring->capacity) {
+    ring->_headCache = atomic_load_explicit(&ring->_head, memory_order_acquire);
+    if (tail - ring->_headCache == ring->capacity) {
+      return false;
+    }
+  }
+
+  memcpy(_RING_SLOT(ring, tail), data, ring->_buffer._typeSize);
+  atomic_store_explicit(&ring->_tail, tail + 1, memory_order_release);
+  return true;
+}
+
+/**
+ * Consumer side only.
+ * @return  false if the ring is empty
+ */
+bool SpscRingBuffer_pop(SpscRingBuffer* ring, void* out) {
+  size_t head = atomic_load_explicit(&ring->_head, memory_order_relaxed);
+  if (head == ring->_tailCache) {
+    ring->_tailCache = atomic_load_explicit(&ring->_tail, memory_order_acquire);
+    if (head == ring->_tailCache) {
+      return false;
+    }
+  }
+
+  memcpy(out, _RING_SLOT(ring, head), ring->_buffer._typeSize);
+  atomic_store_explicit(&ring->_head, head + 1, memory_order_release);
+  return true;
+}
+
+/**
+ * Only a snapshot while the other side keeps going.
+ */
+size_t SpscRingBuffer_size(SpscRingBuffer* ring) {
+  size_t head = atomic_load_explicit(&ring->_head, memory_order_acquire);
+  return atomic_load_explicit(&ring->_tail, memory_order_acquire) - head;
+}
+
+
+/**
+ * @error  S_E_NOMEMS
+ */
+MpmcRingBuffer* initMpmcRingBuffer(MpmcRingBuffer* ring, size_t typeSize,
+                                   size_t capacity, SystemErrNoMems* se) {
+  size_t i;
+  ring->capacity = _RingBuffer_roundCapacity(capacity);
+  ring->_mask = ring->capacity - 1;
+  atomic_init(&ring->_head, 0);
+  atomic_init(&ring->_tail, 0);
+  ring->_sequences.arr = NULL;
+  initVectorAdvanced(&ring->_buffer, typeSize, ring->capacity, NULL, 0, NULL,
+                     NULL, se);
+  if (!se->any) {
+    initVectorAdvanced(&ring->_sequences, sizeof(CP_ATOMIC(size_t)),
+                       ring->capacity, NULL, 0, NULL, NULL, se);
+  }
+
+  if (!se->any) {
+    // Slot i is ready to be pushed on lap 0 when its sequence is i
+    for (i = 0; i < ring->capacity; ++i) {
+      atomic_init((CP_ATOMIC(size_t)*) ring->_sequences.arr + i, i);
+    }
+  }
+
+  return ring;
+}
+
+void deinitMpmcRingBuffer(MpmcRingBuffer* ring) {
+  deinitVector(&ring->_buffer);
+  deinitVector(&ring->_sequences);
+}
+
+/**
+ * Safe from any number of threads.
+ * @return  false if the ring is full
+ */
+bool MpmcRingBuffer_push(MpmcRingBuffer* ring, const void* data) {
+  CP_ATOMIC(size_t)* sequence;
+  size_t pos = atomic_load_explicit(&ring->_tail, memory_order_relaxed);
+  for (;;) {
+    ptrdiff_t lap;
+    sequence = (CP_ATOMIC(size_t)*) ring->_sequences.arr + (pos & ring->_mask);
+    lap = (ptrdiff_t) (atomic_load_explicit(sequence, memory_order_acquire) - pos);
+    if (lap == 0) {
+      if (atomic_compare_exchange_weak_explicit(&ring->_tail, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (lap < 0) {
+      return false; // The slot still holds last lap's element
+    } else {
+      pos = atomic_load_explicit(&ring->_tail, memory_order_relaxed);
+    }
+  }
+
+  memcpy(_RING_SLOT(ring, pos), data, ring->_buffer._typeSize);
+  atomic_store_explicit(sequence, pos + 1, memory_order_release);
+  return true;
+}
+
+/**
+ * Safe from any number of threads.
+ * @return  false if the ring is empty
+ */
+bool MpmcRingBuffer_pop(MpmcRingBuffer* ring, void* out) {
+  CP_ATOMIC(size_t)* sequence;
+  size_t pos = atomic_load_explicit(&ring->_head, memory_order_relaxed);
+  for (;;) {
+    ptrdiff_t lap;
+    sequence = (CP_ATOMIC(size_t)*) ring->_sequences.arr + (pos & ring->_mask);
+    lap = (ptrdiff_t) (atomic_load_explicit(sequence, memory_order_acquire) -
+                       (pos + 1));
+    if (lap == 0) {
+      if (atomic_compare_exchange_weak_explicit(&ring->_head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+        break;
+      }
+    } else if (lap < 0) {
+      return false; // Nothing pushed into the slot yet this lap
+    } else {
+      pos = atomic_load_explicit(&ring->_head, memory_order_relaxed);
+    }
+  }
+
+  memcpy(out, _RING_SLOT(ring, pos), ring->_buffer._typeSize);
+  atomic_store_explicit(sequence, pos + ring->capacity, memory_order_release);
+  return true;
+}
+
+/**
+ * Only a snapshot while other threads keep going.
+ */
+size_t MpmcRingBuffer_size(MpmcRingBuffer* ring) {
+  size_t head = atomic_load_explicit(&ring->_head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&ring->_tail, memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
+
+
+size_t _RingBuffer_roundCapacity(size_t capacity) {
+  size_t rounded = 1;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+#endif
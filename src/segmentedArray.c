@@ -0,0 +1,101 @@
+#include "segmentedArray.h"
+
+#ifndef __BCC__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * [firstSegmentLength] is rounded up to a power of two.
+ */
+SegmentedArray* initSegmentedArray(SegmentedArray* arr, size_t typeSize,
+                                   size_t firstSegmentLength) {
+  size_t i;
+  arr->_typeSize = typeSize;
+  arr->_firstShift = 0;
+  while (((size_t) 1 << arr->_firstShift) < firstSegmentLength) {
+    arr->_firstShift++;
+  }
+
+  for (i = 0; i < SEGMENTED_ARRAY_SEGMENTS; ++i) {
+    atomic_init(&arr->_segments[i], NULL);
+  }
+
+  return arr;
+}
+
+/**
+ * Not thread safe. Every other thread has to be done with the array.
+ */
+void deinitSegmentedArray(SegmentedArray* arr) {
+  size_t i;
+  for (i = 0; i < SEGMENTED_ARRAY_SEGMENTS; ++i) {
+    free(atomic_load_explicit(&arr->_segments[i], memory_order_relaxed));
+    atomic_store_explicit(&arr->_segments[i], NULL, memory_order_relaxed);
+  }
+}
+
+/**
+ * The element at [index], which must have been reserved already by this
+ * thread or one it synchronized with.
+ */
+void* SegmentedArray_at(SegmentedArray* arr, size_t index) {
+  size_t offset;
+  size_t segment = _SegmentedArray_segmentOf(arr, index, &offset);
+  return atomic_load_explicit(&arr->_segments[segment], memory_order_acquire) +
+         offset * arr->_typeSize;
+}
+
+/**
+ * Same as SegmentedArray_at() except the segment holding [index] is
+ * allocated if it isn't already. Threads racing to allocate the same segment
+ * settle on one of them and the rest are freed.
+ * @error  S_E_NOMEMS
+ */
+void* SegmentedArray_reserve(SegmentedArray* arr, size_t index,
+                             SystemErrNoMems* se) {
+  size_t offset;
+  size_t segment = _SegmentedArray_segmentOf(arr, index, &offset);
+  char* storage;
+  char* expected = NULL;
+  if (segment >= SEGMENTED_ARRAY_SEGMENTS) {
+    se->any = true;
+    sprintf(se->msg, "SegmentedArray reserve: No more memory available");
+    return NULL;
+  }
+
+  storage = atomic_load_explicit(&arr->_segments[segment], memory_order_acquire);
+  if (storage == NULL) {
+    storage = (char*) calloc((size_t) 1 << (arr->_firstShift + segment),
+                             arr->_typeSize);
+    if (storage == NULL) {
+      se->any = true;
+      sprintf(se->msg, "SegmentedArray reserve: No more memory available");
+      return NULL;
+    }
+
+    if (!atomic_compare_exchange_strong_explicit(&arr->_segments[segment],
+                                                 &expected, storage,
+                                                 memory_order_acq_rel,
+                                                 memory_order_acquire)) {
+      free(storage);
+      storage = expected;
+    }
+  }
+
+  return storage + offset * arr->_typeSize;
+}
+
+/**
+ * Segment s holds the 2^s * first elements starting at (2^s - 1) * first.
+ */
+size_t _SegmentedArray_segmentOf(const SegmentedArray* arr, size_t index,
+                                 size_t* offset) {
+  size_t scaled = (index >> arr->_firstShift) + 1;
+  size_t segment = sizeof(unsigned long long) * 8 - 1 -
+                   __builtin_clzll((unsigned long long) scaled);
+  *offset = index - ((((size_t) 1 << segment) - 1) << arr->_firstShift);
+  return segment;
+}
+
+#endif
@@ -1,9 +1,12 @@
 #include "stdarg.h"
 #include "string.h"
-#include "math.h"
 #include "stringVector.h"
 
+#include "allocStats.h"
+#include "byteScan.h"
+
 #define _STRING_VECTOR_INIT_SIZE 64
+#define _STRING_VECTOR_ALIGN 16
 
 /**
  * Any Vector function can be used on a String. [contents] is a primitive 
@@ -16,12 +19,54 @@
  */
 String* initString(String* str, const char* contents, SystemErrNoMems* e) {
   size_t len = contents ? strlen(contents) : 0;
-  return initByteVector(str, _STRING_VECTOR_INIT_SIZE, contents, len, e);
+  return initStringN(str, contents, len, e);
+}
+
+/**
+ * Same as initString() except the length of [contents] is given, so it
+ * doesn't need to be NUL terminated. An empty String starts out with room
+ * for _STRING_VECTOR_INIT_SIZE bytes since it's likely about to be filled.
+ * Otherwise the buffer is only as big as [contents] (rounded up to
+ * _STRING_VECTOR_ALIGN), because most Strings made from contents are short
+ * tokens that never grow.
+ * @error  S_E_NOMEMS
+ */
+String* initStringN(String* str, const char* contents, size_t len,
+                    SystemErrNoMems* e) {
+  return initStringWithAllocator(str, contents, len, NULL, e);
+}
+
+/**
+ * Same as initStringN() except the characters are stored in memory from
+ * [allocator], NULL for the global one. [allocator] must outlive the String.
+ * @error  S_E_NOMEMS
+ */
+String* initStringWithAllocator(String* str, const char* contents, size_t len,
+                                const Allocator* allocator, SystemErrNoMems* e) {
+  size_t initSize = _STRING_VECTOR_INIT_SIZE;
+  if (len) {
+    initSize = (len + _STRING_VECTOR_ALIGN) & ~(size_t) (_STRING_VECTOR_ALIGN - 1);
+  }
+
+  return _Vector_initOfKind(str, sizeof(char), initSize, contents, len, NULL,
+                            NULL, allocator, ALLOC_KIND_STRING, e);
 }
 
+/**
+ * The copy uses the same allocator as [copyString].
+ * @error  S_E_NOMEMS
+ */
 String* initStringCp(String* str, const String* copyString, SystemErrNoMems* e) {
-  return initByteVector(str, copyString->_arrSize, copyString->arr,
-                        copyString->length, e);
+  return initStringWithAllocator(str, copyString->arr, copyString->length,
+                                 copyString->_allocator, e);
+}
+
+/**
+ * Takes over the buffer of [moved] without copying it. [moved] is left
+ * deinitialized.
+ */
+String* initStringMove(String* str, String* moved) {
+  return initVectorMove(str, moved);
 }
 
 void deinitString(String* str) {
@@ -35,9 +80,92 @@ char String_charAt(const String* str, size_t index, VectorErrRange* e) {
   return *(char*) Vector_at(str, index, e);
 }
 
+/**
+ * Orders Strings by their contents like strcmp(), except the known lengths
+ * are used so embedded NULs don't cut the comparison short.
+ */
 int String_cmp(const String* str, const String* comparedToStr) {
-  return strcmp(str->arr, comparedToStr->arr);
+  StringView view;
+  StringView comparedToView;
+  return StringView_cmp(String_view(str, &view),
+                        String_view(comparedToStr, &comparedToView));
+}
+
+/**
+ * Checks the lengths before comparing any characters, so it's the way to go
+ * when ordering doesn't matter.
+ */
+bool String_equals(const String* str, const String* other) {
+  StringView view;
+  StringView otherView;
+  return StringView_equals(String_view(str, &view), String_view(other, &otherView));
+}
+
+/**
+ * Counts how many times [c] occurs in [str], e.g. the number of lines.
+ */
+size_t String_count(const String* str, char c) {
+  return ByteScan_count(str->arr, str->length, c);
+}
+
+/**
+ * Finds the first occurrence of the NUL terminated [needle] in [str] at or
+ * after [start].
+ * @return  The index of the match or STRING_NPOS
+ */
+size_t String_find(const String* str, const char* needle, size_t start) {
+  size_t found;
+  if (start > str->length) {
+    return STRING_NPOS;
+  }
+
+  found = start + ByteScan_find((char*) str->arr + start, str->length - start,
+                                needle, strlen(needle));
+  return found < str->length ? found : STRING_NPOS;
+}
+
+/**
+ * Finds the first character in [str] at or after [start] that's any of the
+ * characters in [chars].
+ * @return  The index of the match or STRING_NPOS
+ */
+size_t String_findAny(const String* str, const char* chars, size_t start) {
+  ByteSet set;
+  size_t found;
+  if (start > str->length) {
+    return STRING_NPOS;
+  }
+
+  initByteSet(&set, chars);
+  found = start + ByteScan_findAny((char*) str->arr + start,
+                                   str->length - start, &set);
+  return found < str->length ? found : STRING_NPOS;
+}
+
+/**
+ * @return  The index of the first [c] at or after [start] or STRING_NPOS
+ */
+size_t String_findChar(const String* str, char c, size_t start) {
+  size_t found;
+  if (start > str->length) {
+    return STRING_NPOS;
+  }
+
+  found = start + ByteScan_findChar((char*) str->arr + start,
+                                    str->length - start, c);
+  return found < str->length ? found : STRING_NPOS;
+}
+
+#ifndef __BCC__
+/**
+ * Fast non-cryptographic hash of the contents of [str]. Equal Strings and
+ * StringViews always hash the same.
+ */
+u64 String_hash(const String* str) {
+  StringView view;
+  return StringView_hash(String_view(str, &view));
 }
+#endif
 
 #if __BCC__
 void String_gets(String* str) {
@@ -65,7 +193,7 @@ void String_fgets(String* str, FILE* fd, SystemErrNoMems* se) {
   fgets(str->arr, (int) str->_arrSize, fd);
   str->length = strlen(str->arr);
   if (str->length) {
-    while (!se && *(char*) Vector_last(str, &e) != '\n' && !feof(fd)) {
+    while (!se->any && *(char*) Vector_last(str, &e) != '\n' && !feof(fd)) {
       char tmpStr[1024];
       fgets(tmpStr, 1024, fd);
       len = strlen(tmpStr);
@@ -74,7 +202,7 @@ void String_fgets(String* str, FILE* fd, SystemErrNoMems* se) {
   }
 }
 
-void String_catnprintf(String* str, uint n, Err* se, const char* fmt, ...) {
+void String_catnprintf(String* str, size_t n, Err* se, const char* fmt, ...) {
   _Vector_resize(str, n, se);
 
   if (!se->any) {
@@ -100,44 +228,161 @@ void String_nprintf(String* str, size_t n, Err* se, const char* fmt, ...) {
   }
 }
 
+/**
+ * Parses [str] as an integer in [base]. Gives 0 for anything that isn't a
+ * number that fits in an int; use String_toi64() to tell those apart.
+ */
 int String_toi(const String* str, int base) {
-  int num = 0;
-  int i;
-  VectorErrRange ve;
-  ve.any = false;
-  for (i = 0; i < str->length; ++i) {
-    char* c = Vector_at(str, str->length - 1 - i, &ve);
-    if (*c < '0' + base && *c >= '0') {
-      num += (*c - '0') * pow(base, i);
-    } else if (*c < base - 10 + 'A' && *c >= 'A') {
-      num += (*c - 'A' + 10) * pow(base, i);
-    } else {
-      return 0;
-    }
+  StringErrParse pe;
+  i64 num;
+  pe.any = false;
+  num = String_toi64(str, base, &pe);
+  return pe.any || num != (int) num ? 0 : (int) num;
+}
+
+/**
+ * See StringView_tod()
+ * @error  StringErrParse
+ */
+double String_tod(const String* str, StringErrParse* pe) {
+  StringView view;
+  return StringView_tod(String_view(str, &view), pe);
+}
+
+/**
+ * See StringView_toi64()
+ * @error  StringErrParse
+ */
+i64 String_toi64(const String* str, int base, StringErrParse* pe) {
+  StringView view;
+  return StringView_toi64(String_view(str, &view), base, pe);
+}
+
+/**
+ * See StringView_tou64()
+ * @error  StringErrParse
+ */
+u64 String_tou64(const String* str, int base, StringErrParse* pe) {
+  StringView view;
+  return StringView_tou64(String_view(str, &view), base, pe);
+}
+
+/**
+ * Parses every String in [strs] into [doubles], a Vector of double. See
+ * StringView_batchTod().
+ * @error  StringErrParse
+ * @error  S_E_NOMEMS
+ */
+void String_batchTod(const Vector* strs, Vector* doubles, StringErrParse* pe,
+                     SystemErrNoMems* se) {
+  Vector views;
+  _String_viewAll(strs, &views, se);
+  if (!se->any) {
+    StringView_batchTod(&views, doubles, pe, se);
+  }
+  deinitVector(&views);
+}
+
+/**
+ * Parses every String in [strs] into [ints], a Vector of i64. See
+ * StringView_batchToi64().
+ * @error  StringErrParse
+ * @error  S_E_NOMEMS
+ */
+void String_batchToi64(const Vector* strs, Vector* ints, int base,
+                       StringErrParse* pe, SystemErrNoMems* se) {
+  Vector views;
+  _String_viewAll(strs, &views, se);
+  if (!se->any) {
+    StringView_batchToi64(&views, ints, base, pe, se);
   }
+  deinitVector(&views);
+}
 
-  return num;
+/**
+ * Fills [views] with a StringView of each String in [strs].
+ * @error  S_E_NOMEMS
+ */
+void _String_viewAll(const Vector* strs, Vector* views, SystemErrNoMems* se) {
+  size_t i;
+  StringView* view;
+  initVectorAdvanced(views, sizeof(StringView), strs->length + 1, NULL, 0,
+                     NULL, NULL, se);
+  if (se->any) {
+    return;
+  }
+
+  view = (StringView*) views->arr;
+  for (i = 0; i < strs->length; ++i) {
+    String_view((const String*) strs->arr + i, view + i);
+  }
+  views->length = strs->length;
+  _Vector_appendNull(views);
 }
 #endif
 
 /**
+ * Splits [str] on any of the characters in [delimiters] and fills
+ * [tokenContainer] with a String for each token. Each token String is
+ * initialized right inside the container, so [tokenContainer] takes ownership
+ * and should have deinitString() as its deinitializer. Tokens use the same
+ * allocator as [tokenContainer], so a container in an Arena gets its tokens
+ * there too.
  * @error  S_E_NOMEMS
  */
 void String_tok(const String* str, Vector* tokenContainer,
                 const char* delimiters, SystemErrNoMems* e) {
   char* tokenized = (char*) malloc(str->length + 1);
   char* token;
-  String strToken;
+  String* strToken;
   Vector_clear(tokenContainer);
+  if (tokenized == NULL) {
+    e->any = true;
+    sprintf(e->msg, "String_tok: No more memory available");
+    return;
+  }
 
   memcpy(tokenized, str->arr, str->length + 1);
   token = strtok(tokenized, delimiters);
-  while (token != NULL) {
-    initString(&strToken, token, e);
-    Vector_add(tokenContainer, &strToken, e);
-    deinitString(&strToken);
+  while (token != NULL && !e->any) {
+    strToken = (String*) Vector_addEmpty(tokenContainer, e);
+    if (strToken) {
+      initStringWithAllocator(strToken, token, strlen(token),
+                              tokenContainer->_allocator, e);
+      if (e->any) {
+        Vector_removeLast(tokenContainer);
+      }
+    }
+
     token = strtok(NULL, delimiters);
   }
 
   free(tokenized);
 }
+
+/**
+ * Same as String_tok() but without copying anything. [viewContainer] must be
+ * a Vector of StringView and gets views into [str], so it's only good until
+ * [str] changes. Reentrant, unlike String_tok().
+ * @error  S_E_NOMEMS
+ */
+void String_tokView(const String* str, Vector* viewContainer,
+                    const char* delimiters, SystemErrNoMems* e) {
+  StringView view;
+  StringView_tok(String_view(str, &view), viewContainer, delimiters, e);
+}
+
+/**
+ * Splits [str] into the fields between any of the [delimiters], keeping
+ * empty fields. See StringView_split().
+ * @error  S_E_NOMEMS
+ */
+void String_split(const String* str, Vector* viewContainer,
+                  const char* delimiters, SystemErrNoMems* e) {
+  StringView view;
+  StringView_split(String_view(str, &view), viewContainer, delimiters, e);
+}
+
+StringView* String_view(const String* str, StringView* view) {
+  return initStringView(view, str->arr, str->length);
+}
@@ -0,0 +1,492 @@
+#include "stringView.h"
+
+#include "byteScan.h"
+#include "hash.h"
+
+#include "string.h"
+
+
+StringView* initStringView(StringView* view, const char* data, size_t length) {
+  view->data = data;
+  view->length = length;
+  return view;
+}
+
+/**
+ * Compares [view] to [other] like memcmp() over their full lengths, with a
+ * view that's a prefix of the other ordered first. Embedded NULs are
+ * compared like any other character.
+ */
+int StringView_cmp(const StringView* view, const StringView* other) {
+  size_t minLength = view->length < other->length ? view->length : other->length;
+  int cmp = minLength ? memcmp(view->data, other->data, minLength) : 0;
+  if (cmp == 0 && view->length != other->length) {
+    cmp = view->length < other->length ? -1 : 1;
+  }
+
+  return cmp;
+}
+
+/**
+ * Faster than StringView_cmp() when only equality matters since views of
+ * different lengths are told apart without touching their characters.
+ */
+bool StringView_equals(const StringView* view, const StringView* other) {
+  return view->length == other->length &&
+    (view->length == 0 || memcmp(view->data, other->data, view->length) == 0);
+}
+
+#ifndef __BCC__
+u64 StringView_hash(const StringView* view) {
+  return Hash_bytes(view->data, view->length, HASH_DEFAULT_SEED);
+}
+#endif
+
+/**
+ * Takes the first line off the front of [remaining] and points [line] at it,
+ * without its '\n'. Walking a whole buffer line by line this way copies
+ * nothing.
+ * @return  false when [remaining] is empty
+ */
+bool StringView_popLine(StringView* remaining, StringView* line) {
+  size_t newline;
+  if (remaining->length == 0) {
+    return false;
+  }
+
+  newline = ByteScan_findChar(remaining->data, remaining->length, '\n');
+  initStringView(line, remaining->data, newline);
+  if (newline < remaining->length) {
+    ++newline;
+  }
+  remaining->data += newline;
+  remaining->length -= newline;
+  return true;
+}
+
+/**
+ * Splits [view] on any of the characters in [delimiters] and fills
+ * [viewContainer] with a StringView for each token, skipping empty tokens
+ * like strtok() does. [viewContainer] must be a Vector of StringView. The
+ * views point into [view] so nothing is copied. Unlike strtok() there's no
+ * hidden state, so it's safe to use from several threads at once.
+ * @error  S_E_NOMEMS
+ */
+void StringView_tok(const StringView* view, Vector* viewContainer,
+                    const char* delimiters, SystemErrNoMems* se) {
+  ByteSet delimiterSet;
+  const u8* chars = (const u8*) view->data;
+  size_t i = 0;
+  size_t end;
+  StringView token;
+  Vector_clear(viewContainer);
+  initByteSet(&delimiterSet, delimiters);
+
+  while (i < view->length && !se->any) {
+    while (i < view->length && delimiterSet.contains[chars[i]]) {
+      ++i;
+    }
+
+    end = i + ByteScan_findAny(view->data + i, view->length - i, &delimiterSet);
+    if (end > i) {
+      initStringView(&token, view->data + i, end - i);
+      Vector_add(viewContainer, &token, se);
+    }
+    i = end;
+  }
+}
+
+/**
+ * Splits [view] on every one of the characters in [delimiters] and fills
+ * [viewContainer] with a StringView for each field. Unlike StringView_tok()
+ * empty fields are kept, so "a,,b" split on "," gives three fields.
+ * @error  S_E_NOMEMS
+ */
+void StringView_split(const StringView* view, Vector* viewContainer,
+                      const char* delimiters, SystemErrNoMems* se) {
+  ByteSet delimiterSet;
+  size_t i = 0;
+  size_t end;
+  StringView field;
+  Vector_clear(viewContainer);
+  initByteSet(&delimiterSet, delimiters);
+
+  do {
+    end = i + ByteScan_findAny(view->data + i, view->length - i, &delimiterSet);
+    initStringView(&field, view->data + i, end - i);
+    Vector_add(viewContainer, &field, se);
+    i = end + 1;
+  } while (end < view->length && !se->any);
+}
+
+#ifndef __BCC__
+#include "stdio.h"
+#include "stdlib.h"
+#include "errno.h"
+
+#define _STRING_VIEW_MAX_EXACT_POW10 22
+#define _STRING_VIEW_STRTOD_BUF 128
+
+static const double _exactPowersOf10[_STRING_VIEW_MAX_EXACT_POW10 + 1] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool _StringView_isSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static int _StringView_digitValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'z') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'Z') {
+    return c - 'A' + 10;
+  }
+
+  return 36;
+}
+
+static void _StringView_trim(const StringView* view, const char** begin,
+                             const char** end) {
+  *begin = view->data;
+  *end = view->data + view->length;
+  while (*begin < *end && _StringView_isSpace(**begin)) {
+    ++*begin;
+  }
+  while (*end > *begin && _StringView_isSpace(*(*end - 1))) {
+    --*end;
+  }
+}
+
+static void _StringView_parseError(const char* begin, const char* end,
+                                   const char* problem, StringErrParse* pe) {
+  int shown = end - begin > 64 ? 64 : (int) (end - begin);
+  pe->any = true;
+  sprintf(pe->msg, "Parse error: \"%.*s\" %s", shown, begin, problem);
+}
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define _STRING_VIEW_SWAR 1
+
+/*
+ * SWAR digit parsing: eight ASCII digits loaded as one little endian u64 are
+ * validated and combined with three multiplies instead of eight.
+ */
+static bool _StringView_isEightDigits(u64 chunk) {
+  return (((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
+
+static u32 _StringView_parseEightDigits(u64 chunk) {
+  chunk -= 0x3030303030303030ULL;
+  chunk = chunk * 10 + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32))))
+          >> 32;
+  return (u32) chunk;
+}
+#endif
+
+/**
+ * Accumulates the digits of [base] starting at [p] into [value]. Stops at the
+ * first character that isn't a digit and returns where that is.
+ * [overflowed] is set if [value] didn't fit.
+ */
+static const char* _StringView_accumulate(const char* p, const char* end,
+                                          int base, u64* value,
+                                          bool* overflowed) {
+  u64 limit = ~0ULL / (u64) base;
+  int digit;
+#if _STRING_VIEW_SWAR
+  // Eight more digits fit as long as value * 10^8 + 99999999 can't overflow
+  const u64 swarLimit = (~0ULL - 99999999ULL) / 100000000ULL;
+  if (base == 10) {
+    u64 chunk;
+    while (end - p >= 8 && *value <= swarLimit) {
+      memcpy(&chunk, p, sizeof(chunk));
+      if (!_StringView_isEightDigits(chunk)) {
+        break;
+      }
+      *value = *value * 100000000ULL + _StringView_parseEightDigits(chunk);
+      p += 8;
+    }
+  }
+#endif
+
+  while (p < end && (digit = _StringView_digitValue(*p)) < base) {
+    if (*value > limit || *value * base > ~0ULL - digit) {
+      *overflowed = true;
+    }
+    *value = *value * base + digit;
+    ++p;
+  }
+
+  return p;
+}
+
+/**
+ * Works out the base and skips any 0x or 0 prefix like strtol() does.
+ */
+static int _StringView_detectBase(const char** p, const char* end, int base) {
+  bool hexPrefix = end - *p >= 3 && (*p)[0] == '0' &&
+    ((*p)[1] == 'x' || (*p)[1] == 'X') && _StringView_digitValue((*p)[2]) < 16;
+  if ((base == 0 || base == 16) && hexPrefix) {
+    *p += 2;
+    return 16;
+  } else if (base == 0) {
+    return end - *p >= 2 && (*p)[0] == '0' ? 8 : 10;
+  }
+
+  return base;
+}
+
+/**
+ * Parses the magnitude shared by StringView_toi64() and StringView_tou64().
+ * [negative] is set when there's a leading '-'.
+ */
+static u64 _StringView_parseInteger(const StringView* view, int base,
+                                    bool* negative, StringErrParse* pe) {
+  const char* begin;
+  const char* end;
+  const char* p;
+  const char* digitsStart;
+  u64 value = 0;
+  bool overflowed = false;
+  _StringView_trim(view, &begin, &end);
+  p = begin;
+  *negative = false;
+
+  if (base != 0 && (base < 2 || base > 36)) {
+    pe->any = true;
+    sprintf(pe->msg, "Parse error: Invalid base %d", base);
+    return 0;
+  }
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    *negative = *p == '-';
+    ++p;
+  }
+
+  base = _StringView_detectBase(&p, end, base);
+  digitsStart = p;
+  p = _StringView_accumulate(p, end, base, &value, &overflowed);
+  if (p == digitsStart || p != end) {
+    _StringView_parseError(begin, end, "isn't an integer", pe);
+    return 0;
+  } else if (overflowed) {
+    _StringView_parseError(begin, end, "is out of range", pe);
+    return 0;
+  }
+
+  return value;
+}
+
+/**
+ * Parses [view] as an integer in [base] (2 to 36, or 0 to go by the prefix
+ * like strtol()). Surrounding whitespace and a leading sign are allowed and
+ * letters of either case are digits. Anything else is an error.
+ * @error  StringErrParse
+ */
+i64 StringView_toi64(const StringView* view, int base, StringErrParse* pe) {
+  bool negative;
+  u64 magnitude = _StringView_parseInteger(view, base, &negative, pe);
+  u64 limit = negative ? (u64) 1 << 63 : ((u64) 1 << 63) - 1;
+  if (!pe->any && magnitude > limit) {
+    _StringView_parseError(view->data, view->data + view->length,
+                           "is out of range", pe);
+    return 0;
+  }
+
+  return negative ? (i64) (0 - magnitude) : (i64) magnitude;
+}
+
+/**
+ * Unsigned version of StringView_toi64(). A minus sign is an error unless the
+ * value is 0.
+ * @error  StringErrParse
+ */
+u64 StringView_tou64(const StringView* view, int base, StringErrParse* pe) {
+  bool negative;
+  u64 value = _StringView_parseInteger(view, base, &negative, pe);
+  if (!pe->any && negative && value != 0) {
+    _StringView_parseError(view->data, view->data + view->length,
+                           "is out of range", pe);
+    return 0;
+  }
+
+  return value;
+}
+
+/**
+ * strtod() needs a NUL terminated string so the view is copied to the stack
+ * first. Only used for what the fast path in StringView_tod() can't handle.
+ */
+static double _StringView_strtod(const char* begin, const char* end,
+                                 StringErrParse* pe) {
+  char buf[_STRING_VIEW_STRTOD_BUF];
+  char* stop;
+  double value;
+  if (end - begin >= _STRING_VIEW_STRTOD_BUF) {
+    _StringView_parseError(begin, end, "is too long for a number", pe);
+    return 0;
+  }
+
+  memcpy(buf, begin, end - begin);
+  buf[end - begin] = '\0';
+  errno = 0;
+  value = strtod(buf, &stop);
+  if (stop == buf || *stop != '\0') {
+    _StringView_parseError(begin, end, "isn't a number", pe);
+    return 0;
+  } else if (errno == ERANGE && (value > 1 || value < -1)) {
+    _StringView_parseError(begin, end, "is out of range", pe);
+  }
+
+  return value;
+}
+
+/**
+ * Parses [view] as a decimal floating point number. Surrounding whitespace is
+ * allowed. Numbers whose digits fit in 53 bits and whose exponent is small
+ * (the usual case for numeric columns) are converted with a single exact
+ * multiply or divide. Everything else, hex floats and inf/nan included, goes through
+ * strtod(). Results are correctly rounded either way.
+ * @error  StringErrParse
+ */
+double StringView_tod(const StringView* view, StringErrParse* pe) {
+  const char* begin;
+  const char* end;
+  const char* p;
+  const char* digitsStart;
+  u64 mantissa = 0;
+  bool overflowed = false;
+  bool negative = false;
+  long exponent = 0;
+  long digits;
+  double value;
+  _StringView_trim(view, &begin, &end);
+  p = begin;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = *p == '-';
+    ++p;
+  }
+
+  digitsStart = p;
+  p = _StringView_accumulate(p, end, 10, &mantissa, &overflowed);
+  digits = p - digitsStart;
+  if (p < end && *p == '.') {
+    const char* fractionStart = ++p;
+    p = _StringView_accumulate(p, end, 10, &mantissa, &overflowed);
+    exponent = -(long) (p - fractionStart);
+    digits += p - fractionStart;
+  }
+
+  if (digits > 0 && p < end && (*p == 'e' || *p == 'E')) {
+    bool negativeExponent = false;
+    const char* exponentStart;
+    u64 explicitExponent = 0;
+    ++p;
+    if (p < end && (*p == '-' || *p == '+')) {
+      negativeExponent = *p == '-';
+      ++p;
+    }
+
+    exponentStart = p;
+    p = _StringView_accumulate(p, end, 10, &explicitExponent, &overflowed);
+    if (p == exponentStart || explicitExponent > 10000) {
+      return _StringView_strtod(begin, end, pe);
+    }
+    exponent += negativeExponent ? -(long) explicitExponent : (long) explicitExponent;
+  }
+
+  if (digits == 0 || p != end || overflowed ||
+      mantissa > ((u64) 1 << 53) ||
+      exponent < -_STRING_VIEW_MAX_EXACT_POW10 ||
+      exponent > _STRING_VIEW_MAX_EXACT_POW10) {
+    return _StringView_strtod(begin, end, pe);
+  }
+
+  value = (double) mantissa;
+  if (exponent < 0) {
+    value /= _exactPowersOf10[-exponent];
+  } else {
+    value *= _exactPowersOf10[exponent];
+  }
+
+  return negative ? -value : value;
+}
+
+/**
+ * Parses every StringView in [views] and appends the results to [doubles], a
+ * Vector of double. Stops at the first bad number, with its index in the
+ * error message.
+ * @error  StringErrParse
+ * @error  S_E_NOMEMS
+ */
+void StringView_batchTod(const Vector* views, Vector* doubles,
+                         StringErrParse* pe, SystemErrNoMems* se) {
+  const StringView* view = (const StringView*) views->arr;
+  double* out;
+  size_t i;
+  // The failing index is taken from the loop, so an error from before
+  // would point before the first view
+  if (pe->any) {
+    return;
+  }
+
+  Vector_reserve(doubles, doubles->length + views->length, se);
+  if (se->any) {
+    return;
+  }
+
+  out = (double*) _Vector_calcDanglingPtr(doubles);
+  for (i = 0; i < views->length && !pe->any; ++i) {
+    out[i] = StringView_tod(view + i, pe);
+  }
+
+  if (pe->any) {
+    sprintf(pe->msg + strlen(pe->msg), " at %lu", (unsigned long) (i - 1));
+    --i;
+  }
+  doubles->length += i;
+  _Vector_appendNull(doubles);
+}
+
+/**
+ * Integer version of StringView_batchTod(). [ints] is a Vector of i64.
+ * @error  StringErrParse
+ * @error  S_E_NOMEMS
+ */
+void StringView_batchToi64(const Vector* views, Vector* ints, int base,
+                           StringErrParse* pe, SystemErrNoMems* se) {
+  const StringView* view = (const StringView*) views->arr;
+  i64* out;
+  size_t i;
+  // The failing index is taken from the loop, so an error from before
+  // would point before the first view
+  if (pe->any) {
+    return;
+  }
+
+  Vector_reserve(ints, ints->length + views->length, se);
+  if (se->any) {
+    return;
+  }
+
+  out = (i64*) _Vector_calcDanglingPtr(ints);
+  for (i = 0; i < views->length && !pe->any; ++i) {
+    out[i] = StringView_toi64(view + i, base, pe);
+  }
+
+  if (pe->any) {
+    sprintf(pe->msg + strlen(pe->msg), " at %lu", (unsigned long) (i - 1));
+    --i;
+  }
+  ints->length += i;
+  _Vector_appendNull(ints);
+}
+#endif
@@ -0,0 +1,398 @@
+#include "unrolledList.h"
+
+#ifndef __BCC__
+
+#include "stdlib.h"
+#include "string.h"
+
+void* _UnrolledList_slot(const UnrolledList* list, const UnrolledChunk* chunk,
+                         size_t i);
+UnrolledChunk* _UnrolledList_newChunk(UnrolledList* list, UnrolledChunk* before,
+                                      SystemErr* se);
+void _UnrolledList_freeChunk(UnrolledList* list, UnrolledChunk* chunk);
+UnrolledChunk* _UnrolledList_locate(const UnrolledList* list, size_t index,
+                                    size_t* offset);
+void _UnrolledList_copyInto(UnrolledList* list, void* slot, const void* data,
+                            SystemErr* se);
+
+UnrolledList* initUnrolledList(UnrolledList* list, size_t typeSize,
+                               void* (*copyInitializer)(void*, const void*, SystemErr*),
+                               void (*deInitializer)(void*)) {
+  return initUnrolledListAdvanced(list, typeSize, 0, copyInitializer,
+                                  deInitializer);
+}
+
+/**
+ * [chunkSize] is the size in bytes of each chunk, header included, 0 for
+ * UNROLLED_LIST_DEFAULT_CHUNK_SIZE. A chunk always has room for at least one
+ * element.
+ */
+UnrolledList* initUnrolledListAdvanced(UnrolledList* list, size_t typeSize,
+                                       size_t chunkSize,
+                                       void* (*copyInitializer)(void*, const void*, SystemErr*),
+                                       void (*deInitializer)(void*)) {
+  size_t header = offsetof(UnrolledChunk, data);
+  chunkSize = chunkSize ? chunkSize : UNROLLED_LIST_DEFAULT_CHUNK_SIZE;
+  list->firstChunk = NULL;
+  list->lastChunk = NULL;
+  list->length = 0;
+  list->_copyInitializer = copyInitializer;
+  list->_deInitializer = deInitializer;
+  list->_typeSize = typeSize;
+  list->_chunkCapacity = chunkSize > header + typeSize ?
+    (chunkSize - header) / typeSize : 1;
+  return list;
+}
+
+void deinitUnrolledList(UnrolledList* list) {
+  UnrolledList_clear(list);
+}
+
+
+void UnrolledList_append(UnrolledList* list, const void* data, SystemErr* se) {
+  UnrolledChunk* chunk = list->lastChunk;
+  if (chunk == NULL || chunk->start + chunk->count == list->_chunkCapacity) {
+    if (chunk != NULL && chunk->count < list->_chunkCapacity) {
+      // Room left at the front only. Slide everything down.
+      memmove(_UnrolledList_slot(list, chunk, 0),
+              _UnrolledList_slot(list, chunk, chunk->start),
+              chunk->count * list->_typeSize);
+      chunk->start = 0;
+    } else {
+      chunk = _UnrolledList_newChunk(list, NULL, se);
+      if (chunk == NULL) {
+        return;
+      }
+    }
+  }
+
+  chunk->count++;
+  list->length++;
+  _UnrolledList_copyInto(list,
+                         _UnrolledList_slot(list, chunk, chunk->start + chunk->count - 1),
+                         data, se);
+}
+
+/**
+ * Appends a zeroed element and returns it to be initialized.
+ * @error  S_E_NOMEMS
+ */
+void* UnrolledList_appendEmpty(UnrolledList* list, SystemErr* se) {
+  size_t length = list->length;
+  UnrolledList_append(list, NULL, se);
+  return list->length > length ? UnrolledList_last(list) : NULL;
+}
+
+void UnrolledList_prepend(UnrolledList* list, const void* data, SystemErr* se) {
+  UnrolledChunk* chunk = list->firstChunk;
+  if (chunk == NULL || chunk->start == 0) {
+    if (chunk != NULL && chunk->count < list->_chunkCapacity) {
+      // Room left at the back only. Slide everything up.
+      size_t start = list->_chunkCapacity - chunk->count;
+      memmove(_UnrolledList_slot(list, chunk, start),
+              _UnrolledList_slot(list, chunk, 0),
+              chunk->count * list->_typeSize);
+      chunk->start = start;
+    } else {
+      chunk = _UnrolledList_newChunk(list, list->firstChunk, se);
+      if (chunk == NULL) {
+        return;
+      }
+      chunk->start = list->_chunkCapacity;
+    }
+  }
+
+  chunk->start--;
+  chunk->count++;
+  list->length++;
+  _UnrolledList_copyInto(list, _UnrolledList_slot(list, chunk, chunk->start),
+                         data, se);
+}
+
+/**
+ * Inserts a copy of [data] so it ends up at [index]. Only the elements of one
+ * chunk are shifted. A full chunk is split in two first.
+ * @error  S_E_NOMEMS
+ * @error  LL_E_RANGE
+ */
+void UnrolledList_insertAt(UnrolledList* list, size_t index, const void* data,
+                           SystemErr* se, LLErr* le) {
+  UnrolledChunk* chunk;
+  size_t offset;
+  size_t ts = list->_typeSize;
+  if (index > list->length) {
+    *le = LL_E_RANGE;
+    return;
+  } else if (index == list->length) {
+    UnrolledList_append(list, data, se);
+    return;
+  } else if (index == 0) {
+    UnrolledList_prepend(list, data, se);
+    return;
+  }
+
+  chunk = _UnrolledList_locate(list, index, &offset);
+  if (chunk->count == list->_chunkCapacity) {
+    UnrolledChunk* split = _UnrolledList_newChunk(list, chunk->next, se);
+    size_t kept = chunk->count / 2;
+    if (split == NULL) {
+      return;
+    }
+
+    split->count = chunk->count - kept;
+    memcpy(_UnrolledList_slot(list, split, 0),
+           _UnrolledList_slot(list, chunk, chunk->start + kept), split->count * ts);
+    chunk->count = kept;
+    if (offset > kept) {
+      offset -= kept;
+      chunk = split;
+    }
+  }
+
+  if (chunk->start + chunk->count < list->_chunkCapacity) {
+    memmove(_UnrolledList_slot(list, chunk, chunk->start + offset + 1),
+            _UnrolledList_slot(list, chunk, chunk->start + offset),
+            (chunk->count - offset) * ts);
+  } else {
+    memmove(_UnrolledList_slot(list, chunk, chunk->start - 1),
+            _UnrolledList_slot(list, chunk, chunk->start), offset * ts);
+    chunk->start--;
+  }
+
+  chunk->count++;
+  list->length++;
+  _UnrolledList_copyInto(list, _UnrolledList_slot(list, chunk, chunk->start + offset),
+                         data, se);
+}
+
+
+/**
+ * Walks from whichever end of the list is closer, skipping whole chunks.
+ * @error  LL_E_RANGE
+ */
+void* UnrolledList_at(const UnrolledList* list, size_t index, LLErr* le) {
+  UnrolledChunk* chunk;
+  size_t offset;
+  if (index >= list->length) {
+    *le = LL_E_RANGE;
+    return NULL;
+  }
+
+  chunk = _UnrolledList_locate(list, index, &offset);
+  return _UnrolledList_slot(list, chunk, chunk->start + offset);
+}
+
+void* UnrolledList_first(const UnrolledList* list) {
+  return _UnrolledList_slot(list, list->firstChunk, list->firstChunk->start);
+}
+
+void* UnrolledList_last(const UnrolledList* list) {
+  UnrolledChunk* last = list->lastChunk;
+  return _UnrolledList_slot(list, last, last->start + last->count - 1);
+}
+
+void UnrolledList_clear(UnrolledList* list) {
+  UnrolledChunk* chunk = list->firstChunk;
+  size_t i;
+  while (chunk != NULL) {
+    UnrolledChunk* next = chunk->next;
+    if (list->_deInitializer) {
+      for (i = 0; i < chunk->count; ++i) {
+        list->_deInitializer(_UnrolledList_slot(list, chunk, chunk->start + i));
+      }
+    }
+    free(chunk);
+    chunk = next;
+  }
+
+  list->firstChunk = NULL;
+  list->lastChunk = NULL;
+  list->length = 0;
+}
+
+
+/**
+ * Removes the element at [index], shifting only the rest of its chunk. A
+ * chunk is freed as soon as it's empty.
+ * @error  LL_E_RANGE
+ */
+void UnrolledList_removeAt(UnrolledList* list, size_t index, LLErr* le) {
+  UnrolledChunk* chunk;
+  size_t offset;
+  if (index >= list->length) {
+    *le = LL_E_RANGE;
+    return;
+  }
+
+  chunk = _UnrolledList_locate(list, index, &offset);
+  if (list->_deInitializer) {
+    list->_deInitializer(_UnrolledList_slot(list, chunk, chunk->start + offset));
+  }
+
+  if (offset == 0) {
+    chunk->start++;
+  } else if (offset < chunk->count - 1) {
+    memmove(_UnrolledList_slot(list, chunk, chunk->start + offset),
+            _UnrolledList_slot(list, chunk, chunk->start + offset + 1),
+            (chunk->count - offset - 1) * list->_typeSize);
+  }
+
+  chunk->count--;
+  list->length--;
+  if (chunk->count == 0) {
+    _UnrolledList_freeChunk(list, chunk);
+  }
+}
+
+void UnrolledList_removeFirst(UnrolledList* list) {
+  LLErr le = LL_E_CLEAR;
+  UnrolledList_removeAt(list, 0, &le);
+}
+
+void UnrolledList_removeLast(UnrolledList* list) {
+  LLErr le = LL_E_CLEAR;
+  UnrolledList_removeAt(list, list->length - 1, &le);
+}
+
+/**
+ * Finds an item in the list with the given comparison function. With a NULL
+ * [cmp] elements are compared byte for byte, with no call per element.
+ * @errors LL_E_NOT_FOUND
+ */
+void* UnrolledList_find(UnrolledList* list, void* dataToFind,
+                        bool (*cmp)(void* dataToFind, void* itemData), LLErr* le) {
+  UnrolledChunk* chunk = list->firstChunk;
+  size_t i;
+  while (chunk != NULL) {
+    char* item = (char*) _UnrolledList_slot(list, chunk, chunk->start);
+    for (i = 0; i < chunk->count; ++i, item += list->_typeSize) {
+      if (cmp ? cmp(dataToFind, item)
+              : memcmp(dataToFind, item, list->_typeSize) == 0) {
+        return item;
+      }
+    }
+
+    chunk = chunk->next;
+  }
+
+  *le = LL_E_NOT_FOUND;
+
+  return NULL;
+}
+
+/**
+ * Calls [fn] on every element in order, passing [context] along.
+ */
+void UnrolledList_forEach(UnrolledList* list, void (*fn)(void* item, void* context),
+                          void* context) {
+  UnrolledChunk* chunk = list->firstChunk;
+  size_t i;
+  while (chunk != NULL) {
+    char* item = (char*) _UnrolledList_slot(list, chunk, chunk->start);
+    for (i = 0; i < chunk->count; ++i, item += list->_typeSize) {
+      fn(item, context);
+    }
+
+    chunk = chunk->next;
+  }
+}
+
+
+void* _UnrolledList_slot(const UnrolledList* list, const UnrolledChunk* chunk,
+                         size_t i) {
+  return (char*) chunk->data + i * list->_typeSize;
+}
+
+/**
+ * Allocates an empty chunk and links it in before [before], or at the end if
+ * NULL.
+ * @error  S_E_NOMEMS
+ */
+UnrolledChunk* _UnrolledList_newChunk(UnrolledList* list, UnrolledChunk* before,
+                                      SystemErr* se) {
+  UnrolledChunk* chunk = (UnrolledChunk*) malloc(
+    offsetof(UnrolledChunk, data) + list->_chunkCapacity * list->_typeSize);
+  UnrolledChunk* after = before ? before->prev : list->lastChunk;
+  if (chunk == NULL) {
+    *se = S_E_NOMEMS;
+    return NULL;
+  }
+
+  chunk->start = 0;
+  chunk->count = 0;
+  chunk->prev = after;
+  chunk->next = before;
+  if (after) {
+    after->next = chunk;
+  } else {
+    list->firstChunk = chunk;
+  }
+
+  if (before) {
+    before->prev = chunk;
+  } else {
+    list->lastChunk = chunk;
+  }
+
+  return chunk;
+}
+
+void _UnrolledList_freeChunk(UnrolledList* list, UnrolledChunk* chunk) {
+  if (chunk->prev) {
+    chunk->prev->next = chunk->next;
+  } else {
+    list->firstChunk = chunk->next;
+  }
+
+  if (chunk->next) {
+    chunk->next->prev = chunk->prev;
+  } else {
+    list->lastChunk = chunk->prev;
+  }
+
+  free(chunk);
+}
+
+/**
+ * Finds the chunk holding element [index] and the element's [offset] among
+ * the chunk's elements.
+ */
+UnrolledChunk* _UnrolledList_locate(const UnrolledList* list, size_t index,
+                                    size_t* offset) {
+  UnrolledChunk* chunk;
+  if (index < list->length / 2) {
+    chunk = list->firstChunk;
+    while (index >= chunk->count) {
+      index -= chunk->count;
+      chunk = chunk->next;
+    }
+  } else {
+    index = list->length - 1 - index;
+    chunk = list->lastChunk;
+    while (index >= chunk->count) {
+      index -= chunk->count;
+      chunk = chunk->prev;
+    }
+    index = chunk->count - 1 - index;
+  }
+
+  *offset = index;
+  return chunk;
+}
+
+/**
+ * Copies [data] into [slot], or zeroes it if [data] is NULL.
+ */
+void _UnrolledList_copyInto(UnrolledList* list, void* slot, const void* data,
+                            SystemErr* se) {
+  if (data == NULL) {
+    memset(slot, 0, list->_typeSize);
+  } else if (list->_copyInitializer) {
+    memset(slot, 0, list->_typeSize);
+    list->_copyInitializer(slot, data, se);
+  } else {
+    memcpy(slot, data, list->_typeSize);
+  }
+}
+
+#endif
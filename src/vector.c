@@ -1,7 +1,17 @@
 #include "vector.h"
 
+#include "allocStats.h"
 #include "string.h" // memcpy() has to do with strings apparently
 
+const VectorGrowthPolicy VECTOR_GROWTH_DOUBLE = { 2, 1, 0, 0, 0 };
+const VectorGrowthPolicy VECTOR_GROWTH_1_5X = { 3, 2, 0, 0, 0 };
+#ifndef __BCC__
+// 2MiB huge pages once a buffer reaches 4MiB
+const VectorGrowthPolicy VECTOR_GROWTH_HUGE_PAGES = {
+  2, 1, 0, (size_t) 2 << 20, (size_t) 4 << 20
+};
+#endif
+
 
 /**
  * @errors  S_E_NOMEMS
@@ -17,9 +27,29 @@ Vector* initVector(Vector* v, size_t typeSize,
  * @errors  S_E_NOMEMS
  */
 Vector* initVectorCp(Vector* v, const Vector* copy, Err* se) {
-  return initVectorAdvanced(v, copy->_typeSize, copy->_arrSize,
-                            copy->arr, copy->length, copy->_copyInitializer,
-                            copy->_deInitializer, se);
+  _Vector_initOfKind(v, copy->_typeSize, copy->_arrSize, NULL, 0,
+                     copy->_copyInitializer, copy->_deInitializer,
+                     copy->_allocator, copy->_allocKind, se);
+  if (!se->any) {
+    v->_rangeCopyInitializer = copy->_rangeCopyInitializer;
+    v->_growthPolicy = copy->_growthPolicy;
+    Vector_catPrimitive(v, copy->arr, copy->length, se);
+  }
+
+  return v;
+}
+
+/**
+ * Initializes [v] by taking over the contents of [moved] without copying any
+ * elements. [moved] is left deinitialized and must be initialized again
+ * before being reused. Deinitializing it is harmless.
+ */
+Vector* initVectorMove(Vector* v, Vector* moved) {
+  *v = *moved;
+  moved->arr = NULL;
+  moved->length = 0;
+  moved->_arrSize = 0;
+  return v;
 }
 
 /**
@@ -40,19 +70,54 @@ Vector* initVectorAdvanced(Vector* v, size_t typeSize, size_t initSize,
                            const void* contents, size_t num,
                            void* (*cpInitializer)(void*, const void*, Err*),
                            void (*deInitializer)(void*), SystemErrNoMems* se) {
+  return initVectorWithAllocator(v, typeSize, initSize, contents, num,
+                                 cpInitializer, deInitializer, NULL, se);
+}
+
+/**
+ * Same as initVectorAdvanced() except the array comes from [allocator], NULL
+ * for the global one. [allocator] must outlive the Vector.
+ * @error S_E_NOMEMS
+ */
+Vector* initVectorWithAllocator(Vector* v, size_t typeSize, size_t initSize,
+                                const void* contents, size_t num,
+                                void* (*cpInitializer)(void*, const void*, Err*),
+                                void (*deInitializer)(void*),
+                                const Allocator* allocator, SystemErrNoMems* se) {
+  return _Vector_initOfKind(v, typeSize, initSize, contents, num, cpInitializer,
+                            deInitializer, allocator, ALLOC_KIND_VECTOR, se);
+}
+
+/**
+ * Same as initVectorWithAllocator() except the Vector is counted as
+ * [allocKind] by AllocStats, e.g. ALLOC_KIND_STRING.
+ * @error S_E_NOMEMS
+ */
+Vector* _Vector_initOfKind(Vector* v, size_t typeSize, size_t initSize,
+                           const void* contents, size_t num,
+                           void* (*cpInitializer)(void*, const void*, Err*),
+                           void (*deInitializer)(void*),
+                           const Allocator* allocator, u8 allocKind,
+                           SystemErrNoMems* se) {
   initSize = initSize < 2 ? _VECTOR_DEFAULT_INIT_SIZE : initSize;
   initSize = initSize > num ? initSize: num + 1; // +1 remember null end
 
-  v->arr = malloc(typeSize * initSize);
+  v->arr = Allocator_alloc(allocator, typeSize * initSize);
   if (v->arr == NULL) {
     se->any = true;
     sprintf(se->msg, "initVector: No more memory available");
+  } else {
+    AllocStats_recordAlloc((AllocKind) allocKind, typeSize * initSize);
   }
 
   if (!se->any) {
     v->_arrSize = initSize;
     v->_copyInitializer = cpInitializer;
     v->_deInitializer = deInitializer;
+    v->_rangeCopyInitializer = NULL;
+    v->_growthPolicy = NULL;
+    v->_allocator = allocator;
+    v->_allocKind = allocKind;
     v->_typeSize = typeSize;
     v->length = 0;
 
@@ -68,9 +133,13 @@ Vector* initVectorAdvanced(Vector* v, size_t typeSize, size_t initSize,
  * to be reused.
  */
 void deinitVector(Vector* v) {
-  Vector_clear(v);
-  free(v->arr);
-  v->arr = NULL;
+  if (v->arr) {
+    Vector_clear(v);
+    Allocator_release(v->_allocator, v->arr, v->_arrSize * v->_typeSize);
+    AllocStats_recordRelease((AllocKind) v->_allocKind,
+                             v->_arrSize * v->_typeSize);
+    v->arr = NULL;
+  }
 }
 
 
@@ -124,6 +193,31 @@ void* Vector_addEmpty(Vector* v, Err* se) {
   return mems;
 }
 
+/**
+ * Moves [element] into the vector instead of copying it. The bytes of
+ * [element] are taken as is, so whatever it owns (heap buffers and the like)
+ * now belongs to the vector. [element] is zeroed afterwards and shouldn't be
+ * deinitialized. If the vector is full and can't grow, [element] is left
+ * untouched.
+ * @error  S_E_NOMEMS
+ */
+void* Vector_addMove(Vector* v, void* element, SystemErrNoMems* se) {
+  void* arrayPosition;
+
+  _Vector_resize(v, 1, se);
+  if (se->any) {
+    return NULL;
+  }
+
+  arrayPosition = _Vector_calcDanglingPtr(v);
+  memcpy(arrayPosition, element, v->_typeSize);
+  memset(element, 0, v->_typeSize);
+  ++(v->length);
+  _Vector_appendNull(v);
+
+  return arrayPosition;
+}
+
 /**
  * Returns a pointer to the specified [index] value.
  * Error if index is out of range.
@@ -136,7 +230,7 @@ void* Vector_at(const Vector* v, size_t index, VectorErrRange* e) {
     return v->arr;
   }
 
-  return _Vector_calcPtrAt(v, index);
+  return Vector_get(v, index);
 }
 
 /**
@@ -157,20 +251,18 @@ Vector* Vector_cat(Vector* v, const Vector* other, VectorErrIncompatibleTypes* e
 }
 
 /**
+ * Copies [num] elements from the primitive array [arr] onto the end of [v].
+ * Vectors without a copy initializer get the whole block in one memcpy.
  * @error  S_E_NOMEMS
  */
 Vector* Vector_catPrimitive(Vector* v, const void* arr, size_t num, SystemErrNoMems* se) {
-  int i;
-
   if (num > 0) {
     _Vector_resize(v, num, se);
     if (se->any) {
       return v;
     }
 
-    for (i = 0; i < num; ++i) {
-      _Vector_appendCopy(v, ((char*) arr) + i * v->_typeSize, se);
-    }
+    _Vector_appendCopies(v, arr, num, se);
 
     // For compatibility with primitive array functions, always append a NULL
     // value.
@@ -181,13 +273,10 @@ Vector* Vector_catPrimitive(Vector* v, const void* arr, size_t num, SystemErrNoM
 }
 
 Vector* Vector_clear(Vector* v) {
-  int i;
-  VectorErrRange eIgnore;
-  void* el;
-  eIgnore.any = false;
+  char* el;
+  char* end = (char*) _Vector_calcDanglingPtr(v);
   if (v->_deInitializer) {
-    for (i = 0; i < v->length; ++i) { 
-      el = (void*) Vector_at(v, i, &eIgnore);
+    for (el = (char*) v->arr; el < end; el += v->_typeSize) {
       v->_deInitializer(el);
     }
   }
@@ -198,18 +287,98 @@ Vector* Vector_clear(Vector* v) {
   return v;
 }
 
+/**
+ * Calls [fn] on each element of [v] in order, passing [context] along.
+ */
+void Vector_forEach(Vector* v, void (*fn)(void* item, void* context),
+                    void* context) {
+  char* el;
+  char* end = (char*) _Vector_calcDanglingPtr(v);
+  for (el = (char*) v->arr; el < end; el += v->_typeSize) {
+    fn(el, context);
+  }
+}
+
+/**
+ * Appends an element to [mapped] for each element of [v], made by [fn] from
+ * the element of [v]. The two Vectors can hold different types. [mapped]
+ * grows once up front and each new element is zeroed before [fn] fills it
+ * in, the same as with a copy initializer.
+ * @return  [mapped]
+ * @error   S_E_NOMEMS
+ */
+Vector* Vector_map(const Vector* v, Vector* mapped,
+                   void (*fn)(void* to, const void* from, void* context),
+                   void* context, SystemErrNoMems* se) {
+  const char* from;
+  char* to;
+  char* end;
+  _Vector_resize(mapped, v->length, se);
+  if (se->any) {
+    return mapped;
+  }
+
+  from = (const char*) v->arr;
+  to = (char*) _Vector_calcDanglingPtr(mapped);
+  end = to + v->length * mapped->_typeSize;
+  memset(to, 0, end - to);
+  for (; to < end; to += mapped->_typeSize, from += v->_typeSize) {
+    fn(to, from, context);
+  }
+
+  mapped->length += v->length;
+  _Vector_appendNull(mapped);
+  return mapped;
+}
+
+/**
+ * Folds each element of [v] into [accumulator] with [fn], in order.
+ * [accumulator] starts out as whatever it points to.
+ * @return  [accumulator]
+ */
+void* Vector_reduce(const Vector* v, void* accumulator,
+                    void (*fn)(void* accumulator, const void* item, void* context),
+                    void* context) {
+  const char* el;
+  const char* end = (const char*) _Vector_calcDanglingPtr(v);
+  for (el = (const char*) v->arr; el < end; el += v->_typeSize) {
+    fn(accumulator, el, context);
+  }
+
+  return accumulator;
+}
+
+/**
+ * Makes sure [v] can hold at least [capacity] elements without having to
+ * grow again. Never shrinks.
+ * @error  S_E_NOMEMS
+ */
+void Vector_reserve(Vector* v, size_t capacity, SystemErrNoMems* se) {
+  if (v->_arrSize <= capacity) {
+    _Vector_setArrSize(v, capacity + 1 /* Null element */, se);
+  }
+}
+
+/**
+ * Releases any room [v] holds beyond its elements and the trailing null
+ * element.
+ * @error  S_E_NOMEMS
+ */
+void Vector_shrinkToFit(Vector* v, SystemErrNoMems* se) {
+  if (v->_arrSize > v->length + 1) {
+    _Vector_setArrSize(v, v->length + 1, se);
+  }
+}
+
 /**
  * @error  V_E_EMPTY
  */
 void* Vector_last(Vector* v, VectorErrEmpty* e) {
-  VectorErrRange eIgnore;
-  eIgnore.any = false;
   if (v->length == 0) {
     e->any = 1;
     sprintf(e->msg, "Empty vector");
   } else {
-    size_t last = v->length - 1;
-    return Vector_at(v, last, &eIgnore);
+    return Vector_get(v, v->length - 1);
   }
 
   return NULL;
@@ -230,6 +399,36 @@ void Vector_removeLast(Vector* v) {
   }
 }
 
+/**
+ * Sets a copy initializer that copies a whole range of elements in one call.
+ * When set, it's used instead of the per element copy initializer whenever a
+ * block of elements is copied in (Vector_cat, Vector_catPrimitive,
+ * initVectorCp). The destination range is zeroed before it's called, just like
+ * with the per element copy initializer.
+ */
+void Vector_setRangeCopyInitializer(Vector* v,
+                                    void* (*rangeCpInitializer)(void*, const void*,
+                                                                size_t, Err*)) {
+  v->_rangeCopyInitializer = rangeCpInitializer;
+}
+
+/**
+ * Sets how [v] grows from now on. [policy] isn't copied so it must outlive
+ * the vector. NULL restores the default doubling.
+ */
+void Vector_setGrowthPolicy(Vector* v, const VectorGrowthPolicy* policy) {
+  v->_growthPolicy = policy;
+}
+
+/**
+ * Exchanges the contents of two vectors. Nothing is copied or allocated.
+ */
+void Vector_swap(Vector* a, Vector* b) {
+  Vector tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
 /**
  * Copies a reversed version of [v] into [reversed]
  * @error  S_E_NOMEMS
@@ -253,6 +452,26 @@ void* _Vector_appendCopy(Vector* v, const void* element, Err* se) {
   return arrayPosition;
 }
 
+/**
+ * Copies [num] elements onto the end of [v]. Space must already be reserved.
+ */
+void _Vector_appendCopies(Vector* v, const void* elements, size_t num, Err* se) {
+  size_t i;
+  void* arrayPosition = _Vector_calcDanglingPtr(v);
+  if (v->_rangeCopyInitializer) {
+    memset(arrayPosition, 0, num * v->_typeSize);
+    v->_rangeCopyInitializer(arrayPosition, elements, num, se);
+    v->length += num;
+  } else if (v->_copyInitializer) {
+    for (i = 0; i < num; ++i) {
+      _Vector_appendCopy(v, ((const char*) elements) + i * v->_typeSize, se);
+    }
+  } else {
+    memcpy(arrayPosition, elements, num * v->_typeSize);
+    v->length += num;
+  }
+}
+
 void _Vector_appendNull(const Vector* v) {
   memset(_Vector_calcDanglingPtr(v), 0, v->_typeSize);
 }
@@ -270,10 +489,17 @@ void* _Vector_calcDanglingPtr(const Vector* v) {
  */
 void _Vector_reinit(Vector* v, size_t typeSize, size_t* initSize, SystemErrNoMems* se) {
   if (v->_typeSize * v->_arrSize < typeSize * (*initSize)) {
-    void* newMems = realloc(v->arr, typeSize * (*initSize));
+    void* newMems = Allocator_resize(v->_allocator, v->arr,
+                                     v->_typeSize * v->_arrSize,
+                                     typeSize * (*initSize));
     if (newMems == NULL) {
       se->any = true;
       sprintf(se->msg, "Vector reinit: No more memory available");
+    } else {
+      AllocStats_recordResize((AllocKind) v->_allocKind,
+                              v->_typeSize * v->_arrSize,
+                              typeSize * (*initSize), newMems != v->arr);
+      v->arr = newMems;
     }
   } else {
     *initSize = v->_typeSize * v->_arrSize / typeSize;
@@ -281,21 +507,55 @@ void _Vector_reinit(Vector* v, size_t typeSize, size_t* initSize, SystemErrNoMem
 }
 
 /**
+ * Grows [v] so that [numAdded] more elements fit, as dictated by its growth
+ * policy.
  * @error  S_E_NOMEMS
  */
 void _Vector_resize(Vector *v, size_t numAdded, SystemErrNoMems* se) {
-  void* newMems;
+  const VectorGrowthPolicy* policy = v->_growthPolicy;
+  size_t needed;
+  size_t newSize;
+  size_t bytes;
   if (v->_arrSize <= v->length + numAdded) {
-    v->_arrSize = v->length + numAdded + 1 /* Null element */;
-    v->_arrSize *= 2; // For good measure.
-
-    newMems = realloc(v->arr, v->_arrSize * v->_typeSize);
-    if (newMems == NULL) {
-      v->_arrSize = v->length;
-      se->any = true;
-      sprintf(se->msg, "Vector resize: No more memory available");
+    needed = v->length + numAdded + 1 /* Null element */;
+    if (!policy) {
+      newSize = needed * 2; // For good measure.
     } else {
-      v->arr = newMems;
+      newSize = v->_arrSize / policy->factorDen * policy->factorNum;
+      if (policy->maxStep && newSize > v->_arrSize + policy->maxStep) {
+        newSize = v->_arrSize + policy->maxStep;
+      }
+
+      newSize = newSize < needed ? needed : newSize;
+      bytes = newSize * v->_typeSize;
+      if (policy->alignBytes && bytes >= policy->alignThreshold) {
+        bytes = (bytes + policy->alignBytes - 1) / policy->alignBytes *
+                policy->alignBytes;
+        newSize = bytes / v->_typeSize;
+      }
     }
+
+    _Vector_setArrSize(v, newSize, se);
+  }
+}
+
+/**
+ * Reallocates the underlying array to hold exactly [arrSize] elements. [v] is
+ * left untouched if that fails.
+ * @error  S_E_NOMEMS
+ */
+void _Vector_setArrSize(Vector* v, size_t arrSize, SystemErrNoMems* se) {
+  void* newMems = Allocator_resize(v->_allocator, v->arr,
+                                   v->_arrSize * v->_typeSize,
+                                   arrSize * v->_typeSize);
+  if (newMems == NULL) {
+    se->any = true;
+    sprintf(se->msg, "Vector resize: No more memory available");
+  } else {
+    AllocStats_recordResize((AllocKind) v->_allocKind,
+                            v->_arrSize * v->_typeSize, arrSize * v->_typeSize,
+                            newMems != v->arr);
+    v->arr = newMems;
+    v->_arrSize = arrSize;
   }
 }
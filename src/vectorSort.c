@@ -0,0 +1,716 @@
+#include "vectorSort.h"
+
+#include "string.h"
+
+#ifndef __BCC__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "atomics.h"
+
+/**
+ * Vector_parallelSort() splits the range with quicksort partitions. Each
+ * worker keeps the halves it doesn't get to right away in its own deque,
+ * taking the newest back itself while idle workers steal the oldest, which
+ * are the biggest. A worker only ever holds halves from deeper and deeper
+ * partitions, so a deque never needs more than _VECTOR_SORT_MAX_DEPTH tasks.
+ */
+typedef struct _VectorSortTask {
+  char* base;
+  size_t n;
+  uint depth;
+} _VectorSortTask;
+
+typedef struct _VectorSortDeque {
+  pthread_mutex_t lock;
+  _VectorSortTask tasks[_VECTOR_SORT_MAX_DEPTH];
+  size_t top; // Oldest task, where thieves take from
+  size_t count;
+} _VectorSortDeque;
+
+typedef struct _VectorSortPool {
+  _VectorSortDeque* deques;
+  uint workers;
+  size_t typeSize;
+  int (*cmp)(const void*, const void*);
+  CP_ATOMIC(size_t) pending; // Tasks queued or being sorted
+} _VectorSortPool;
+
+typedef struct _VectorSortWorker {
+  _VectorSortPool* pool;
+  uint id;
+} _VectorSortWorker;
+
+void* _VectorSort_work(void* worker);
+void _VectorSort_runTask(_VectorSortPool* pool, uint id, _VectorSortTask task);
+bool _VectorSort_push(_VectorSortDeque* deque, const _VectorSortTask* task);
+bool _VectorSort_pop(_VectorSortDeque* deque, _VectorSortTask* task);
+bool _VectorSort_steal(_VectorSortPool* pool, uint thief, _VectorSortTask* task);
+void _VectorSort_radix32(u32* keys, u32* buffer, size_t n);
+void _VectorSort_radix64(u64* keys, u64* buffer, size_t n);
+#endif
+
+int _VectorSort_charAt(const String* str, size_t depth);
+int _VectorSort_cmpFrom(const String* str, const String* other, size_t depth);
+
+
+/**
+ * Sorts [v] in place by [cmp]. It's an introsort: quicksort with a median of
+ * three pivot, heapsort for ranges that partition badly, and insertion sort
+ * for short ones. Equal elements can end up in any order, see
+ * Vector_stableSort().
+ */
+void Vector_sort(Vector* v, int (*cmp)(const void*, const void*)) {
+  _VectorSort_intro((char*) v->arr, v->length, v->_typeSize, cmp,
+                    _VectorSort_depthLimit(v->length));
+}
+
+/**
+ * Sorts [v] by [cmp] keeping equal elements in the order they were in. It's
+ * a merge sort, so it needs room for a copy of the elements from the
+ * Vector's allocator. [v] is left untouched if there isn't any.
+ * @error  S_E_NOMEMS
+ */
+void Vector_stableSort(Vector* v, int (*cmp)(const void*, const void*),
+                       SystemErrNoMems* se) {
+  size_t n = v->length;
+  size_t size = v->_typeSize;
+  size_t width;
+  size_t lo;
+  char* buffer;
+  char* from;
+  char* to;
+  char* tmp;
+  if (n <= _VECTOR_SORT_SMALL) {
+    _VectorSort_insertion((char*) v->arr, n, size, cmp);
+    return;
+  }
+
+  buffer = (char*) Allocator_alloc(v->_allocator, n * size);
+  if (buffer == NULL) {
+    se->any = true;
+    sprintf(se->msg, "Vector_stableSort: No more memory available");
+    return;
+  }
+
+  from = (char*) v->arr;
+  to = buffer;
+  for (lo = 0; lo < n; lo += _VECTOR_SORT_SMALL) {
+    _VectorSort_insertion(from + lo * size,
+                          n - lo < _VECTOR_SORT_SMALL ? n - lo : _VECTOR_SORT_SMALL,
+                          size, cmp);
+  }
+
+  for (width = _VECTOR_SORT_SMALL; width < n; width *= 2) {
+    for (lo = 0; lo < n; lo += 2 * width) {
+      _VectorSort_merge(from, lo, n - lo < width ? n : lo + width,
+                        n - lo < 2 * width ? n : lo + 2 * width, to, size, cmp);
+    }
+    tmp = from;
+    from = to;
+    to = tmp;
+  }
+
+  if (from != v->arr) {
+    memcpy(v->arr, from, n * size);
+  }
+  Allocator_release(v->_allocator, buffer, n * size);
+}
+
+/**
+ * Sorts a Vector of String by their bytes, the same order as String_cmp().
+ * It's a multikey quicksort, which partitions on one character at a time, so
+ * shared prefixes are only looked at once instead of on every comparison.
+ */
+void Vector_sortStrings(Vector* strs) {
+  _VectorSort_multikey((String*) strs->arr, strs->length, 0);
+}
+
+#ifndef __BCC__
+/**
+ * Sorts a Vector of int, like one from initIntVector(), with an LSD radix
+ * sort. Bytes that every element shares are skipped, so small ranges of
+ * numbers take fewer passes.
+ * @error  S_E_NOMEMS
+ */
+void Vector_sortInts(Vector* v, SystemErrNoMems* se) {
+  u32* keys = (u32*) v->arr;
+  u32* buffer;
+  size_t i;
+  if (v->length < 2) {
+    return;
+  }
+
+  buffer = (u32*) Allocator_alloc(v->_allocator, v->length * sizeof(u32));
+  if (buffer == NULL) {
+    se->any = true;
+    sprintf(se->msg, "Vector_sortInts: No more memory available");
+    return;
+  }
+
+  // Flipping the sign bit orders two's complement ints as unsigned
+  for (i = 0; i < v->length; ++i) {
+    keys[i] ^= 0x80000000u;
+  }
+  _VectorSort_radix32(keys, buffer, v->length);
+  for (i = 0; i < v->length; ++i) {
+    keys[i] ^= 0x80000000u;
+  }
+
+  Allocator_release(v->_allocator, buffer, v->length * sizeof(u32));
+}
+
+/**
+ * Sorts a Vector of double, like one from initDoubleVector(), with an LSD
+ * radix sort over the bits. -0.0 comes before 0.0, and NaNs end up at
+ * either end depending on their sign bit.
+ * @error  S_E_NOMEMS
+ */
+void Vector_sortDoubles(Vector* v, SystemErrNoMems* se) {
+  const u64 sign = (u64) 1 << 63;
+  u64* keys = (u64*) v->arr;
+  u64* buffer;
+  size_t i;
+  if (v->length < 2) {
+    return;
+  }
+
+  buffer = (u64*) Allocator_alloc(v->_allocator, v->length * sizeof(u64));
+  if (buffer == NULL) {
+    se->any = true;
+    sprintf(se->msg, "Vector_sortDoubles: No more memory available");
+    return;
+  }
+
+  // Negatives get all their bits flipped so bigger magnitudes sort lower,
+  // positives just the sign bit so they sort above them
+  for (i = 0; i < v->length; ++i) {
+    keys[i] ^= keys[i] & sign ? ~(u64) 0 : sign;
+  }
+  _VectorSort_radix64(keys, buffer, v->length);
+  for (i = 0; i < v->length; ++i) {
+    keys[i] ^= keys[i] & sign ? sign : ~(u64) 0;
+  }
+
+  Allocator_release(v->_allocator, buffer, v->length * sizeof(u64));
+}
+
+/**
+ * Vector_sort() spread over [threads] threads, the calling one included, 0
+ * for one per processor. Threads that can't be started are done without.
+ * @error  S_E_NOMEMS
+ */
+void Vector_parallelSort(Vector* v, int (*cmp)(const void*, const void*),
+                         uint threads, SystemErrNoMems* se) {
+  _VectorSortPool pool;
+  _VectorSortWorker* workers;
+  pthread_t* ids;
+  _VectorSortTask root;
+  uint started;
+  uint i;
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (uint) online : 1;
+  }
+
+  if (threads == 1 || v->length <= _VECTOR_SORT_PARALLEL_CUTOFF) {
+    Vector_sort(v, cmp);
+    return;
+  }
+
+  pool.deques = (_VectorSortDeque*) malloc(threads * sizeof(_VectorSortDeque));
+  workers = (_VectorSortWorker*) malloc(threads * sizeof(_VectorSortWorker));
+  ids = (pthread_t*) malloc(threads * sizeof(pthread_t));
+  if (pool.deques == NULL || workers == NULL || ids == NULL) {
+    free(pool.deques);
+    free(workers);
+    free(ids);
+    se->any = true;
+    sprintf(se->msg, "Vector_parallelSort: No more memory available");
+    return;
+  }
+
+  pool.workers = threads;
+  pool.typeSize = v->_typeSize;
+  pool.cmp = cmp;
+  atomic_init(&pool.pending, 1);
+  for (i = 0; i < threads; ++i) {
+    pthread_mutex_init(&pool.deques[i].lock, NULL);
+    pool.deques[i].top = 0;
+    pool.deques[i].count = 0;
+    workers[i].pool = &pool;
+    workers[i].id = i;
+  }
+
+  root.base = (char*) v->arr;
+  root.n = v->length;
+  root.depth = _VectorSort_depthLimit(v->length);
+  _VectorSort_push(&pool.deques[0], &root);
+  for (started = 1; started < threads; ++started) {
+    if (pthread_create(&ids[started], NULL, _VectorSort_work, &workers[started])) {
+      break;
+    }
+  }
+
+  _VectorSort_work(&workers[0]);
+  for (i = 1; i < started; ++i) {
+    pthread_join(ids[i], NULL);
+  }
+
+  for (i = 0; i < threads; ++i) {
+    pthread_mutex_destroy(&pool.deques[i].lock);
+  }
+  free(pool.deques);
+  free(workers);
+  free(ids);
+}
+#endif
+
+
+/**
+ * Quicksort gets 2 * log2([n]) partitions before the rest is heapsorted.
+ */
+uint _VectorSort_depthLimit(size_t n) {
+  uint depth = 0;
+  while (n > 1) {
+    n >>= 1;
+    depth += 2;
+  }
+
+  return depth;
+}
+
+void _VectorSort_intro(char* base, size_t n, size_t size,
+                       int (*cmp)(const void*, const void*), uint depth) {
+  size_t split;
+  while (n > _VECTOR_SORT_SMALL) {
+    if (depth == 0) {
+      _VectorSort_heap(base, n, size, cmp);
+      return;
+    }
+
+    --depth;
+    split = _VectorSort_partition(base, n, size, cmp);
+    // Recursing into the smaller side keeps the stack to log2(n) frames
+    if (split < n - split - 1) {
+      _VectorSort_intro(base, split, size, cmp, depth);
+      base += (split + 1) * size;
+      n -= split + 1;
+    } else {
+      _VectorSort_intro(base + (split + 1) * size, n - split - 1, size, cmp,
+                        depth);
+      n = split;
+    }
+  }
+
+  _VectorSort_insertion(base, n, size, cmp);
+}
+
+/**
+ * Partitions [n] > 2 elements around the median of the first, middle and
+ * last ones.
+ * @return  Where the pivot ended up. Everything before it is no greater and
+ *          everything after no less.
+ */
+size_t _VectorSort_partition(char* base, size_t n, size_t size,
+                             int (*cmp)(const void*, const void*)) {
+  char* mid = base + n / 2 * size;
+  char* last = base + (n - 1) * size;
+  size_t i = 0;
+  size_t j = n;
+  if (cmp(mid, base) < 0) {
+    _VectorSort_swap(mid, base, size);
+  }
+  if (cmp(last, mid) < 0) {
+    _VectorSort_swap(last, mid, size);
+    if (cmp(mid, base) < 0) {
+      _VectorSort_swap(mid, base, size);
+    }
+  }
+  _VectorSort_swap(base, mid, size);
+
+  // Stopping on equal elements from both sides splits runs of them evenly
+  for (;;) {
+    do {
+      ++i;
+    } while (i < n && cmp(base + i * size, base) < 0);
+    do {
+      --j;
+    } while (cmp(base + j * size, base) > 0);
+
+    if (i >= j) {
+      break;
+    }
+    _VectorSort_swap(base + i * size, base + j * size, size);
+  }
+
+  _VectorSort_swap(base, base + j * size, size);
+  return j;
+}
+
+void _VectorSort_heap(char* base, size_t n, size_t size,
+                      int (*cmp)(const void*, const void*)) {
+  size_t start = n / 2;
+  size_t end = n;
+  size_t root;
+  size_t child;
+  while (end > 1) {
+    // Heapify from the middle down, then keep moving the top to the end
+    if (start > 0) {
+      --start;
+    } else {
+      --end;
+      _VectorSort_swap(base, base + end * size, size);
+    }
+
+    root = start;
+    while ((child = 2 * root + 1) < end) {
+      if (child + 1 < end &&
+          cmp(base + child * size, base + (child + 1) * size) < 0) {
+        ++child;
+      }
+      if (cmp(base + root * size, base + child * size) >= 0) {
+        break;
+      }
+
+      _VectorSort_swap(base + root * size, base + child * size, size);
+      root = child;
+    }
+  }
+}
+
+/**
+ * Stable, only moves an element past ones that are greater.
+ */
+void _VectorSort_insertion(char* base, size_t n, size_t size,
+                           int (*cmp)(const void*, const void*)) {
+  size_t i;
+  size_t j;
+  for (i = 1; i < n; ++i) {
+    for (j = i; j > 0 && cmp(base + (j - 1) * size, base + j * size) > 0; --j) {
+      _VectorSort_swap(base + (j - 1) * size, base + j * size, size);
+    }
+  }
+}
+
+/**
+ * Merges the sorted runs [lo, mid) and [mid, hi) of [from] into the same
+ * place in [to]. Ties go to the first run.
+ */
+void _VectorSort_merge(const char* from, size_t lo, size_t mid, size_t hi,
+                       char* to, size_t size,
+                       int (*cmp)(const void*, const void*)) {
+  size_t i = lo;
+  size_t j = mid;
+  char* dest = to + lo * size;
+  while (i < mid && j < hi) {
+    if (cmp(from + j * size, from + i * size) < 0) {
+      memcpy(dest, from + j++ * size, size);
+    } else {
+      memcpy(dest, from + i++ * size, size);
+    }
+    dest += size;
+  }
+
+  memcpy(dest, from + i * size, (mid - i) * size);
+  dest += (mid - i) * size;
+  memcpy(dest, from + j * size, (hi - j) * size);
+}
+
+/**
+ * Sorts [n] Strings that all share their first [depth] bytes.
+ */
+void _VectorSort_multikey(String* strs, size_t n, size_t depth) {
+  size_t lt;
+  size_t gt;
+  size_t i;
+  int a;
+  int b;
+  int c;
+  int pivot;
+  String tmp;
+  while (n > 1) {
+    if (n <= _VECTOR_SORT_SMALL) {
+      for (i = 1; i < n; ++i) {
+        for (lt = i; lt > 0 && _VectorSort_cmpFrom(strs + lt - 1, strs + lt, depth) > 0;
+             --lt) {
+          tmp = strs[lt - 1];
+          strs[lt - 1] = strs[lt];
+          strs[lt] = tmp;
+        }
+      }
+      return;
+    }
+
+    a = _VectorSort_charAt(strs, depth);
+    b = _VectorSort_charAt(strs + n / 2, depth);
+    c = _VectorSort_charAt(strs + n - 1, depth);
+    pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+    // Three way partition on the character at [depth]
+    lt = 0;
+    gt = n;
+    i = 0;
+    while (i < gt) {
+      c = _VectorSort_charAt(strs + i, depth);
+      if (c < pivot) {
+        tmp = strs[lt];
+        strs[lt++] = strs[i];
+        strs[i++] = tmp;
+      } else if (c > pivot) {
+        tmp = strs[--gt];
+        strs[gt] = strs[i];
+        strs[i] = tmp;
+      } else {
+        ++i;
+      }
+    }
+
+    _VectorSort_multikey(strs, lt, depth);
+    _VectorSort_multikey(strs + gt, n - gt, depth);
+    if (pivot < 0) {
+      return; // The middle ones all end here, so they're equal
+    }
+
+    strs += lt;
+    n = gt - lt;
+    ++depth;
+  }
+}
+
+/**
+ * Swaps two elements of [size] bytes, a chunk at a time. Word sized
+ * elements get fixed size copies the compiler turns into plain moves.
+ */
+void _VectorSort_swap(char* a, char* b, size_t size) {
+  char tmp[64];
+  size_t chunk;
+  if (size == 4) {
+    memcpy(tmp, a, 4);
+    memcpy(a, b, 4);
+    memcpy(b, tmp, 4);
+    return;
+  } else if (size == 8) {
+    memcpy(tmp, a, 8);
+    memcpy(a, b, 8);
+    memcpy(b, tmp, 8);
+    return;
+  }
+
+  while (size) {
+    chunk = size < sizeof(tmp) ? size : sizeof(tmp);
+    memcpy(tmp, a, chunk);
+    memcpy(a, b, chunk);
+    memcpy(b, tmp, chunk);
+    a += chunk;
+    b += chunk;
+    size -= chunk;
+  }
+}
+
+/**
+ * @return  The byte of [str] at [depth], or -1 past its end so shorter
+ *          Strings sort first.
+ */
+int _VectorSort_charAt(const String* str, size_t depth) {
+  return depth < str->length ? ((const u8*) str->arr)[depth] : -1;
+}
+
+int _VectorSort_cmpFrom(const String* str, const String* other, size_t depth) {
+  size_t len = str->length < other->length ? str->length : other->length;
+  int cmp = memcmp((const char*) str->arr + depth, (const char*) other->arr + depth,
+                   len - depth);
+  if (cmp) {
+    return cmp;
+  }
+
+  return str->length < other->length ? -1 : str->length > other->length;
+}
+
+#ifndef __BCC__
+void* _VectorSort_work(void* worker) {
+  _VectorSortPool* pool = ((_VectorSortWorker*) worker)->pool;
+  uint id = ((_VectorSortWorker*) worker)->id;
+  _VectorSortTask task;
+  while (atomic_load(&pool->pending)) {
+    if (_VectorSort_pop(&pool->deques[id], &task) ||
+        _VectorSort_steal(pool, id, &task)) {
+      _VectorSort_runTask(pool, id, task);
+    } else {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Partitions [task] down to the parallel cutoff, queueing the upper half
+ * each time, and sorts what's left.
+ */
+void _VectorSort_runTask(_VectorSortPool* pool, uint id, _VectorSortTask task) {
+  _VectorSortTask upper;
+  size_t split;
+  while (task.n > _VECTOR_SORT_PARALLEL_CUTOFF && task.depth > 0) {
+    split = _VectorSort_partition(task.base, task.n, pool->typeSize, pool->cmp);
+    --task.depth;
+    upper.base = task.base + (split + 1) * pool->typeSize;
+    upper.n = task.n - split - 1;
+    upper.depth = task.depth;
+    atomic_fetch_add(&pool->pending, 1);
+    if (!_VectorSort_push(&pool->deques[id], &upper)) {
+      _VectorSort_intro(upper.base, upper.n, pool->typeSize, pool->cmp,
+                        upper.depth);
+      atomic_fetch_sub(&pool->pending, 1);
+    }
+    task.n = split;
+  }
+
+  _VectorSort_intro(task.base, task.n, pool->typeSize, pool->cmp, task.depth);
+  atomic_fetch_sub(&pool->pending, 1);
+}
+
+/**
+ * @return  false if [deque] is full.
+ */
+bool _VectorSort_push(_VectorSortDeque* deque, const _VectorSortTask* task) {
+  bool pushed = false;
+  pthread_mutex_lock(&deque->lock);
+  if (deque->count < _VECTOR_SORT_MAX_DEPTH) {
+    deque->tasks[(deque->top + deque->count++) % _VECTOR_SORT_MAX_DEPTH] = *task;
+    pushed = true;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return pushed;
+}
+
+/**
+ * Takes the newest task, the owner's end of [deque].
+ */
+bool _VectorSort_pop(_VectorSortDeque* deque, _VectorSortTask* task) {
+  bool popped = false;
+  pthread_mutex_lock(&deque->lock);
+  if (deque->count) {
+    *task = deque->tasks[(deque->top + --deque->count) % _VECTOR_SORT_MAX_DEPTH];
+    popped = true;
+  }
+  pthread_mutex_unlock(&deque->lock);
+  return popped;
+}
+
+/**
+ * Takes the oldest task from the first other worker that has one.
+ */
+bool _VectorSort_steal(_VectorSortPool* pool, uint thief, _VectorSortTask* task) {
+  _VectorSortDeque* deque;
+  bool stolen = false;
+  uint i;
+  for (i = 1; i < pool->workers && !stolen; ++i) {
+    deque = &pool->deques[(thief + i) % pool->workers];
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count) {
+      *task = deque->tasks[deque->top];
+      deque->top = (deque->top + 1) % _VECTOR_SORT_MAX_DEPTH;
+      --deque->count;
+      stolen = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+  }
+
+  return stolen;
+}
+
+/**
+ * LSD radix sort a byte at a time. All the byte counts are taken in one
+ * pass up front.
+ */
+void _VectorSort_radix32(u32* keys, u32* buffer, size_t n) {
+  size_t counts[4][256];
+  size_t* count;
+  size_t sum;
+  size_t prev;
+  size_t i;
+  uint pass;
+  uint shift;
+  u32* from = keys;
+  u32* to = buffer;
+  u32* tmp;
+  memset(counts, 0, sizeof(counts));
+  for (i = 0; i < n; ++i) {
+    for (pass = 0; pass < 4; ++pass) {
+      ++counts[pass][(keys[i] >> (pass * 8)) & 0xff];
+    }
+  }
+
+  for (pass = 0; pass < 4; ++pass) {
+    count = counts[pass];
+    shift = pass * 8;
+    if (count[(from[0] >> shift) & 0xff] == n) {
+      continue; // Every key has the same byte here
+    }
+
+    for (i = 0, sum = 0; i < 256; ++i) {
+      prev = count[i];
+      count[i] = sum;
+      sum += prev;
+    }
+    for (i = 0; i < n; ++i) {
+      to[count[(from[i] >> shift) & 0xff]++] = from[i];
+    }
+    tmp = from;
+    from = to;
+    to = tmp;
+  }
+
+  if (from != keys) {
+    memcpy(keys, from, n * sizeof(u32));
+  }
+}
+
+/**
+ * Same as _VectorSort_radix32() for 64 bit keys.
+ */
+void _VectorSort_radix64(u64* keys, u64* buffer, size_t n) {
+  size_t counts[8][256];
+  size_t* count;
+  size_t sum;
+  size_t prev;
+  size_t i;
+  uint pass;
+  uint shift;
+  u64* from = keys;
+  u64* to = buffer;
+  u64* tmp;
+  memset(counts, 0, sizeof(counts));
+  for (i = 0; i < n; ++i) {
+    for (pass = 0; pass < 8; ++pass) {
+      ++counts[pass][(keys[i] >> (pass * 8)) & 0xff];
+    }
+  }
+
+  for (pass = 0; pass < 8; ++pass) {
+    count = counts[pass];
+    shift = pass * 8;
+    if (count[(from[0] >> shift) & 0xff] == n) {
+      continue; // Every key has the same byte here
+    }
+
+    for (i = 0, sum = 0; i < 256; ++i) {
+      prev = count[i];
+      count[i] = sum;
+      sum += prev;
+    }
+    for (i = 0; i < n; ++i) {
+      to[count[(from[i] >> shift) & 0xff]++] = from[i];
+    }
+    tmp = from;
+    from = to;
+    to = tmp;
+  }
+
+  if (from != keys) {
+    memcpy(keys, from, n * sizeof(u64));
+  }
+}
+#endif
@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+extern "C" {
+  #include "allocStats.h"
+  #include "allocator.h"
+  #include "hashMap.h"
+  #include "stringVector.h"
+  #include "vector.h"
+}
+
+class AllocStatsMethods : public ::testing::Test {
+public:
+  AllocStatsMethods() {
+    AllocStats_reset();
+    AllocStats_setEnabled(true);
+    movingAllocator.alloc = &alloc;
+    movingAllocator.resize = &resize;
+    movingAllocator.release = &release;
+    movingAllocator.context = NULL;
+  }
+
+  ~AllocStatsMethods() {
+    AllocStats_setEnabled(false);
+  }
+
+  static void* alloc(void* context, size_t size) {
+    return malloc(size);
+  }
+
+  // Never resizes in place, so every resize is a copy
+  static void* resize(void* context, void* ptr, size_t oldSize, size_t size) {
+    void* moved = malloc(size);
+    memcpy(moved, ptr, oldSize < size ? oldSize : size);
+    free(ptr);
+    return moved;
+  }
+
+  static void release(void* context, void* ptr, size_t size) {
+    free(ptr);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  Allocator movingAllocator;
+  AllocStats stats;
+};
+
+TEST_F(AllocStatsMethods, CountsAVectorsLifetime) {
+  Vector v;
+  initVectorAdvanced(&v, sizeof(int), 4, NULL, 0, NULL, NULL, &se);
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_EQ(1, stats.allocs);
+  EXPECT_EQ(4 * sizeof(int), stats.bytesInUse);
+  EXPECT_EQ(1, stats.sizeHistogram[_AllocStats_bucketOf(4 * sizeof(int))]);
+
+  for (int i = 0; i < 100; ++i) {
+    Vector_add(&v, &i, &se);
+  }
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_LT(0, stats.reallocs);
+  EXPECT_EQ(v._arrSize * sizeof(int), stats.bytesInUse);
+  EXPECT_EQ(stats.bytesInUse, stats.peakBytesInUse);
+
+  size_t peak = stats.peakBytesInUse;
+  deinitVector(&v);
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_EQ(1, stats.frees);
+  EXPECT_EQ(0, stats.bytesInUse);
+  EXPECT_EQ(peak, stats.peakBytesInUse);
+}
+
+TEST_F(AllocStatsMethods, CountsCopiesWhenResizesMove) {
+  Vector v;
+  initVectorWithAllocator(&v, sizeof(int), 4, NULL, 0, NULL, NULL,
+                          &movingAllocator, &se);
+  for (int i = 0; i < 4; ++i) {
+    Vector_add(&v, &i, &se);
+  }
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_EQ(1, stats.reallocs);
+  EXPECT_EQ(4 * sizeof(int), stats.reallocCopyBytes);
+  deinitVector(&v);
+}
+
+TEST_F(AllocStatsMethods, KeepsKindsApart) {
+  String str;
+  String copy;
+  Vector v;
+  initString(&str, "Hello", &se);
+  initStringCp(&copy, &str, &se);
+  initVectorCp(&v, &str, &se); // A copy of a String is still counted as one
+  AllocStats_get(ALLOC_KIND_STRING, &stats);
+  EXPECT_EQ(3, stats.allocs);
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_EQ(0, stats.allocs);
+
+  HashMap map;
+  initHashMap(&map, sizeof(int), sizeof(int), NULL, NULL, &se);
+  for (int i = 0; i < 100; ++i) {
+    HashMap_put(&map, &i, &i, &se);
+  }
+  deinitHashMap(&map);
+  AllocStats_get(ALLOC_KIND_HASH_MAP, &stats);
+  EXPECT_EQ(1, stats.allocs);
+  EXPECT_LT(0, stats.reallocs);
+  EXPECT_EQ(1, stats.frees);
+  EXPECT_EQ(0, stats.bytesInUse);
+
+  deinitVector(&v);
+  deinitString(&copy);
+  deinitString(&str);
+  AllocStats_get(ALLOC_KIND_STRING, &stats);
+  EXPECT_EQ(3, stats.frees);
+  EXPECT_EQ(0, stats.bytesInUse);
+}
+
+TEST_F(AllocStatsMethods, DisabledCountsNothing) {
+  String str;
+  AllocStats_setEnabled(false);
+  EXPECT_FALSE(AllocStats_enabled());
+  initString(&str, "Hello", &se);
+  deinitString(&str);
+  AllocStats_get(ALLOC_KIND_STRING, &stats);
+  EXPECT_EQ(0, stats.allocs);
+  EXPECT_EQ(0, stats.frees);
+}
+
+TEST_F(AllocStatsMethods, BlocksFromBeforeEnablingDontWrapBytesInUse) {
+  Vector v;
+  AllocStats_setEnabled(false);
+  initIntVector(&v, NULL, 0, &se);
+  AllocStats_setEnabled(true);
+  deinitVector(&v);
+  AllocStats_get(ALLOC_KIND_VECTOR, &stats);
+  EXPECT_EQ(1, stats.frees);
+  EXPECT_EQ(0, stats.bytesInUse);
+}
+
+TEST_F(AllocStatsMethods, BucketsByPowerOfTwo) {
+  EXPECT_EQ(0, _AllocStats_bucketOf(0));
+  EXPECT_EQ(0, _AllocStats_bucketOf(1));
+  EXPECT_EQ(1, _AllocStats_bucketOf(3));
+  EXPECT_EQ(4, _AllocStats_bucketOf(16));
+  EXPECT_EQ(4, _AllocStats_bucketOf(31));
+  EXPECT_EQ(ALLOC_STATS_BUCKETS - 1, _AllocStats_bucketOf((size_t) -1));
+}
+
+TEST_F(AllocStatsMethods, DumpsJson) {
+  String str;
+  String json;
+  initString(&str, "Hello", &se);
+  initString(&json, NULL, &se);
+  AllocStats_toJson(&json, &se);
+  EXPECT_FALSE(se.any);
+  EXPECT_EQ('{', ((char*) json.arr)[0]);
+  EXPECT_EQ('}', ((char*) json.arr)[json.length - 1]);
+  EXPECT_TRUE(strstr((char*) json.arr, "\"string\": {\"allocs\": 2, ") != NULL);
+  EXPECT_TRUE(strstr((char*) json.arr, "\"hashMap\": {") != NULL);
+  EXPECT_TRUE(strstr((char*) json.arr, "\"sizeHistogram\": [0, ") != NULL);
+  deinitString(&json);
+  deinitString(&str);
+}
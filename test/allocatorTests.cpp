@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "allocator.h"
+  #include "stringVector.h"
+  #include "vector.h"
+}
+
+class CountingAllocator : public ::testing::Test {
+public:
+  CountingAllocator() {
+    allocator.alloc = &alloc;
+    allocator.resize = &resize;
+    allocator.release = &release;
+    allocator.context = &bytesHeld;
+  }
+
+  static void* alloc(void* context, size_t size) {
+    *(size_t*) context += size;
+    return malloc(size);
+  }
+
+  static void* resize(void* context, void* ptr, size_t oldSize, size_t size) {
+    *(size_t*) context += size - oldSize;
+    return realloc(ptr, size);
+  }
+
+  static void release(void* context, void* ptr, size_t size) {
+    *(size_t*) context -= size;
+    free(ptr);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  size_t bytesHeld = 0;
+  Allocator allocator;
+};
+
+TEST_F(CountingAllocator, NullMeansTheGlobalAllocator) {
+  void* p = Allocator_alloc(NULL, 10);
+  p = Allocator_resize(NULL, p, 10, 20);
+  EXPECT_TRUE(p != NULL);
+  Allocator_release(NULL, p, 20);
+  p = Allocator_alloc(&ALLOCATOR_GLOBAL, 10);
+  Allocator_release(&ALLOCATOR_GLOBAL, p, 10);
+}
+
+TEST_F(CountingAllocator, BacksAVectorThroughGrowth) {
+  Vector v;
+  initVectorWithAllocator(&v, sizeof(int), 0, NULL, 0, NULL, NULL, &allocator, &se);
+  for (int i = 0; i < 1000; ++i) {
+    Vector_add(&v, &i, &se);
+  }
+  EXPECT_EQ(v._arrSize * sizeof(int), bytesHeld);
+
+  Vector copy;
+  initVectorCp(&copy, &v, &se);
+  EXPECT_EQ((v._arrSize + copy._arrSize) * sizeof(int), bytesHeld);
+  deinitVector(&copy);
+  deinitVector(&v);
+  EXPECT_EQ(0, bytesHeld);
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(CountingAllocator, BacksAString) {
+  String str;
+  initStringWithAllocator(&str, "counted", 7, &allocator, &se);
+  EXPECT_EQ(str._arrSize, bytesHeld);
+  String_nprintf(&str, 100, &se, "%s", "a longer string than before");
+  EXPECT_EQ(str._arrSize, bytesHeld);
+  deinitString(&str);
+  EXPECT_EQ(0, bytesHeld);
+}
+
+TEST_F(CountingAllocator, FailingAllocationsAreReported) {
+  Allocator failing = allocator;
+  failing.alloc = [](void*, size_t) -> void* { return NULL; };
+  Vector v;
+  initVectorWithAllocator(&v, sizeof(int), 0, NULL, 0, NULL, NULL, &failing, &se);
+  EXPECT_TRUE(se.any);
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "arena.h"
+}
+
+class ArenaMethods : public ::testing::Test {
+public:
+  ArenaMethods() {
+    initArena(&arena, 1024);
+  }
+
+  virtual ~ArenaMethods() {
+    deinitArena(&arena);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  Arena arena;
+};
+
+TEST_F(ArenaMethods, AllocationsAreAlignedAndBumped) {
+  char* a = (char*) Arena_alloc(&arena, 3, &se);
+  char* b = (char*) Arena_alloc(&arena, 5, &se);
+  EXPECT_EQ(0, (size_t) a % ARENA_ALIGN);
+  EXPECT_EQ(a + ARENA_ALIGN, b);
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(ArenaMethods, HugeAllocationsFailInsteadOfWrapping) {
+  EXPECT_EQ(NULL, Arena_alloc(&arena, (size_t) -8, &se));
+  EXPECT_TRUE(se.any);
+}
+
+TEST_F(ArenaMethods, BigAllocationsGetTheirOwnChunk) {
+  char* big = (char*) Arena_alloc(&arena, 5000, &se);
+  memset(big, 1, 5000);
+  EXPECT_TRUE(Arena_alloc(&arena, 10, &se) != NULL);
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(ArenaMethods, RollbackReusesTheSameMemory) {
+  Arena_alloc(&arena, 100, &se);
+  ArenaMark mark;
+  Arena_mark(&arena, &mark);
+  void* first = Arena_alloc(&arena, 100, &se);
+  for (int i = 0; i < 50; ++i) {
+    Arena_alloc(&arena, 100, &se); // Spills into more chunks
+  }
+  Arena_rollback(&arena, &mark);
+  EXPECT_EQ(first, Arena_alloc(&arena, 100, &se));
+}
+
+TEST_F(ArenaMethods, ResetKeepsChunksForReuse) {
+  void* first = Arena_alloc(&arena, 800, &se);
+  Arena_alloc(&arena, 800, &se);
+  Arena_reset(&arena);
+  void* again = Arena_alloc(&arena, 800, &se);
+  void* second = Arena_alloc(&arena, 800, &se);
+  EXPECT_TRUE(again == first || second == first);
+}
+
+TEST_F(ArenaMethods, LoneVectorGrowsInPlace) {
+  Vector* v = Arena_newVector(&arena, sizeof(int), NULL, NULL, &se);
+  void* arr = v->arr;
+  for (int i = 0; i < 100; ++i) {
+    Vector_add(v, &i, &se);
+  }
+  EXPECT_EQ(arr, v->arr);
+  EXPECT_EQ(99, *(int*) Vector_at(v, 99, &se));
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(ArenaMethods, GrowsVectorsPastAChunk) {
+  Vector* a = Arena_newVector(&arena, sizeof(long), NULL, NULL, &se);
+  Vector* b = Arena_newVector(&arena, sizeof(long), NULL, NULL, &se);
+  for (long i = 0; i < 2000; ++i) {
+    Vector_add(a, &i, &se);
+    Vector_add(b, &i, &se);
+  }
+  EXPECT_EQ(1999, *(long*) Vector_at(a, 1999, &se));
+  EXPECT_EQ(1234, *(long*) Vector_at(b, 1234, &se));
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(ArenaMethods, TokenizesIntoTheArena) {
+  String* line = Arena_newString(&arena, "a few short tokens", &se);
+  Vector* tokens = Arena_newVector(&arena, sizeof(String), NULL, NULL, &se);
+  ArenaMark mark;
+  Arena_mark(&arena, &mark);
+  String_tok(line, tokens, " ", &se);
+  ASSERT_EQ(4, tokens->length);
+  String* last = (String*) Vector_at(tokens, 3, &se);
+  EXPECT_STREQ("tokens", (char*) last->arr);
+  EXPECT_EQ(&arena.allocator, last->_allocator);
+  // No deinitString() needed for the tokens
+  Arena_reset(&arena);
+}
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include "concurrentQueue.h"
+}
+
+class ConcurrentQueueMethods : public ::testing::Test {
+public:
+  ConcurrentQueueMethods() {
+    initConcurrentQueue(&q, sizeof(long), &se);
+  }
+
+  virtual ~ConcurrentQueueMethods() {
+    deinitConcurrentQueue(&q);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  ConcurrentQueue q;
+};
+
+TEST_F(ConcurrentQueueMethods, IsFifoAndUnbounded) {
+  long item = 0;
+  EXPECT_FALSE(ConcurrentQueue_pop(&q, &item));
+  for (long i = 0; i < 1000; ++i) {
+    ConcurrentQueue_push(&q, &i, &se);
+  }
+  for (long i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(ConcurrentQueue_pop(&q, &item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(ConcurrentQueue_pop(&q, &item));
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(ConcurrentQueueMethods, RecyclesPoppedNodes) {
+  long item = 7;
+  for (int i = 0; i < 10000; ++i) {
+    ConcurrentQueue_push(&q, &item, &se);
+    ConcurrentQueue_pop(&q, &item);
+  }
+  // The dummy plus the node being swapped with it
+  EXPECT_GE(3, q._nodesUsed);
+}
+
+TEST_F(ConcurrentQueueMethods, StressDeliversEveryElementOnce) {
+  const long perProducer = 50000;
+  const int threads = 4;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      SystemErr pushErr = S_E_CLEAR;
+      for (long i = 0; i < perProducer; ++i) {
+        long item = t * perProducer + i;
+        ConcurrentQueue_push(&q, &item, &pushErr);
+      }
+    });
+  }
+
+  std::vector<std::vector<long>> popped(threads);
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      long item;
+      while ((long) popped[t].size() < perProducer) {
+        if (ConcurrentQueue_pop(&q, &item)) {
+          popped[t].push_back(item);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  std::vector<char> seen(threads * perProducer);
+  for (int t = 0; t < threads; ++t) {
+    long last[threads] = {-1, -1, -1, -1};
+    for (long item : popped[t]) {
+      ASSERT_LT(last[item / perProducer], item);
+      last[item / perProducer] = item;
+      seen[item]++;
+    }
+  }
+  for (long i = 0; i < threads * perProducer; ++i) {
+    ASSERT_EQ(1, seen[i]);
+  }
+}
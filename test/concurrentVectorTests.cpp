@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include "concurrentVector.h"
+}
+
+static int deinitialized = 0;
+
+static void countDeinit(void*) {
+  ++deinitialized;
+}
+
+class ConcurrentVectorMethods : public ::testing::Test {
+public:
+  ConcurrentVectorMethods() {
+    initConcurrentVectorAdvanced(&cv, sizeof(long), 4, NULL, NULL);
+  }
+
+  virtual ~ConcurrentVectorMethods() {
+    deinitConcurrentVector(&cv);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  VectorErrRange re = S_E_CLEAR;
+  ConcurrentVector cv;
+};
+
+TEST_F(ConcurrentVectorMethods, AddReturnsTheIndex) {
+  for (long i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, ConcurrentVector_add(&cv, &i, &se));
+  }
+  EXPECT_EQ(100, ConcurrentVector_length(&cv));
+  EXPECT_EQ(57, *(long*) ConcurrentVector_at(&cv, 57, &re));
+  EXPECT_FALSE(re.any);
+}
+
+TEST_F(ConcurrentVectorMethods, AtOutOfRangeIsAnError) {
+  long item = 1;
+  ConcurrentVector_add(&cv, &item, &se);
+  EXPECT_EQ(NULL, ConcurrentVector_at(&cv, 1, &re));
+  EXPECT_TRUE(re.any);
+}
+
+TEST_F(ConcurrentVectorMethods, ElementsNeverMove) {
+  long items[50];
+  for (long i = 0; i < 50; ++i) {
+    items[i] = i;
+  }
+  ConcurrentVector_catPrimitive(&cv, items, 1, &se);
+  long* first = (long*) ConcurrentVector_at(&cv, 0, &re);
+  EXPECT_EQ(1, ConcurrentVector_catPrimitive(&cv, items + 1, 49, &se));
+  EXPECT_EQ(first, ConcurrentVector_at(&cv, 0, &re));
+  EXPECT_EQ(49, *(long*) ConcurrentVector_at(&cv, 49, &re));
+}
+
+TEST_F(ConcurrentVectorMethods, DeinitializesEveryElement) {
+  ConcurrentVector counted;
+  long item = 0;
+  initConcurrentVector(&counted, sizeof(long), NULL, &countDeinit);
+  for (int i = 0; i < 40; ++i) {
+    ConcurrentVector_add(&counted, &item, &se);
+  }
+  deinitialized = 0;
+  deinitConcurrentVector(&counted);
+  EXPECT_EQ(40, deinitialized);
+}
+
+static void sum(void* item, void* total) {
+  *(long*) total += *(long*) item;
+}
+
+TEST_F(ConcurrentVectorMethods, StressAddsWhileReading) {
+  const long perThread = 20000;
+  const int threads = 4;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      SystemErr addErr = S_E_CLEAR;
+      for (long i = 0; i < perThread; ++i) {
+        long item = t * perThread + i;
+        ConcurrentVector_add(&cv, &item, &addErr);
+      }
+    });
+  }
+  workers.emplace_back([&] {
+    size_t found = 0;
+    while (found < threads * perThread) {
+      VectorErrRange readErr = S_E_CLEAR;
+      long* item = (long*) ConcurrentVector_at(&cv, found, &readErr);
+      if (item) {
+        ASSERT_LT(*item, threads * perThread);
+        ++found;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  long total = 0;
+  ConcurrentVector_forEach(&cv, &sum, &total);
+  long n = threads * perThread;
+  EXPECT_EQ(n * (n - 1) / 2, total);
+}
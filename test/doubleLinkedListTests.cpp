@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+
+extern "C" {
+  #include "doubleLinkedList.h"
+}
+
+class DoubleLinkedListMethods : public ::testing::Test {
+public:
+  DoubleLinkedListMethods() {
+    initDoubleLinkedList(&list, sizeof(int), NULL, NULL);
+    initDoubleLinkedList(&other, sizeof(int), NULL, NULL);
+  }
+
+  virtual ~DoubleLinkedListMethods() {
+    deinitDoubleLinkedList(&list);
+    deinitDoubleLinkedList(&other);
+  }
+
+  void fill(DoubleLinkedList* l, int from, int to) {
+    for (int i = from; i < to; ++i) {
+      DoubleLinkedList_append(l, &i, &se);
+    }
+  }
+
+  std::vector<int> contents(const DoubleLinkedList* l) {
+    std::vector<int> items;
+    for (DoubleLinkedNode* node = l->firstNode; node; node = node->next) {
+      items.push_back(*(int*) node->data);
+    }
+    return items;
+  }
+
+  SystemErr se = S_E_CLEAR;
+  LLErr le = LL_E_CLEAR;
+  DoubleLinkedList list = {};
+  DoubleLinkedList other = {};
+};
+
+static bool intEquals(int* firstInt, int* itemInt) {
+  return *firstInt == *itemInt;
+}
+
+TEST_F(DoubleLinkedListMethods, RemoveLastKeepsBackLinks) {
+  fill(&list, 0, 3);
+  DoubleLinkedList_removeLast(&list);
+  EXPECT_EQ(2, list.length);
+  EXPECT_EQ(1, *(int*) DoubleLinkedList_last(&list));
+  EXPECT_EQ(NULL, list.lastNode->next);
+  DoubleLinkedList_removeLast(&list);
+  DoubleLinkedList_removeLast(&list);
+  EXPECT_EQ(NULL, list.firstNode);
+  EXPECT_EQ(NULL, list.lastNode);
+}
+
+TEST_F(DoubleLinkedListMethods, InsertsAndRemovesAtACursor) {
+  fill(&list, 0, 3);
+  int item = 1;
+  DoubleLinkedNode* cursor = DoubleLinkedList_findNode(
+    &list, &item, (bool (*)(void*, void*)) &intEquals, &le);
+  item = 9;
+  DoubleLinkedList_insertBefore(&list, cursor, &item, &se);
+  DoubleLinkedList_insertAfter(&list, cursor, &item, &se);
+  EXPECT_EQ(std::vector<int>({ 0, 9, 1, 9, 2 }), contents(&list));
+  DoubleLinkedList_remove(&list, cursor);
+  EXPECT_EQ(std::vector<int>({ 0, 9, 9, 2 }), contents(&list));
+  EXPECT_EQ(4, list.length);
+}
+
+TEST_F(DoubleLinkedListMethods, ConcatMovesAllNodes) {
+  fill(&list, 0, 2);
+  fill(&other, 2, 4);
+  DoubleLinkedNode* moved = other.firstNode;
+  DoubleLinkedList_concat(&list, &other, &le);
+  EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3 }), contents(&list));
+  EXPECT_EQ(moved, list.firstNode->next->next);
+  EXPECT_EQ(0, other.length);
+  EXPECT_EQ(NULL, other.firstNode);
+}
+
+TEST_F(DoubleLinkedListMethods, ConcatWithItselfKeepsTheList) {
+  fill(&list, 0, 3);
+  DoubleLinkedList_concat(&list, &list, &le);
+  EXPECT_EQ(LL_E_CLEAR, le);
+  EXPECT_EQ(std::vector<int>({ 0, 1, 2 }), contents(&list));
+  EXPECT_EQ(3, list.length);
+}
+
+TEST_F(DoubleLinkedListMethods, SpliceMovesARange) {
+  fill(&list, 0, 2);
+  fill(&other, 2, 6);
+  DoubleLinkedList_splice(&list, list.lastNode, &other, other.firstNode->next,
+                          other.lastNode->prev, &le);
+  EXPECT_EQ(std::vector<int>({ 0, 3, 4, 1 }), contents(&list));
+  EXPECT_EQ(std::vector<int>({ 2, 5 }), contents(&other));
+  EXPECT_EQ(4, list.length);
+  EXPECT_EQ(2, other.length);
+}
+
+TEST_F(DoubleLinkedListMethods, SpliceWithinAListMovesToFront) {
+  fill(&list, 0, 3);
+  DoubleLinkedList_splice(&list, list.firstNode, &list, list.lastNode,
+                          list.lastNode, &le);
+  EXPECT_EQ(std::vector<int>({ 2, 0, 1 }), contents(&list));
+  EXPECT_EQ(3, list.length);
+}
+
+TEST_F(DoubleLinkedListMethods, ConcatRejectsDifferentTypes) {
+  DoubleLinkedList doubles;
+  initDoubleLinkedList(&doubles, sizeof(double), NULL, NULL);
+  DoubleLinkedList_concat(&list, &doubles, &le);
+  EXPECT_EQ(LL_E_INCOMPATIBLE, le);
+  deinitDoubleLinkedList(&doubles);
+}
+
+TEST_F(DoubleLinkedListMethods, NodeOfFindsTheCursor) {
+  fill(&list, 0, 2);
+  EXPECT_EQ(list.lastNode, DoubleLinkedList_nodeOf(DoubleLinkedList_last(&list)));
+}
@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <unordered_map>
+
+extern "C" {
+  #include "hashMap.h"
+}
+
+class HashMapMethods : public ::testing::Test {
+public:
+  HashMapMethods() {
+    initHashMap(&map, sizeof(int), sizeof(long), NULL, NULL, &se);
+  }
+
+  virtual ~HashMapMethods() {
+    deinitHashMap(&map);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  HashMap map = {};
+};
+
+TEST_F(HashMapMethods, PutGetAndReplace) {
+  int key = 3;
+  long value = 30;
+  HashMap_put(&map, &key, &value, &se);
+  EXPECT_EQ(30, *(long*) HashMap_get(&map, &key));
+  value = 31;
+  HashMap_put(&map, &key, &value, &se);
+  EXPECT_EQ(31, *(long*) HashMap_get(&map, &key));
+  EXPECT_EQ(1, map.length);
+  key = 4;
+  EXPECT_EQ(NULL, HashMap_get(&map, &key));
+}
+
+TEST_F(HashMapMethods, EmplaceZeroesNewValues) {
+  int keys[] = {1, 2, 1, 3, 1};
+  bool inserted;
+  for (int key : keys) {
+    ++*(long*) HashMap_emplace(&map, &key, &inserted, &se);
+  }
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(3, map.length);
+  EXPECT_EQ(3, *(long*) HashMap_get(&map, &keys[0]));
+}
+
+TEST_F(HashMapMethods, MatchesUnorderedMapUnderRandomEdits) {
+  std::unordered_map<int, long> expected;
+  srand(11);
+  for (long i = 0; i < 50000; ++i) {
+    int key = rand() % 3000;
+    if (rand() % 3) {
+      HashMap_put(&map, &key, &i, &se);
+      expected[key] = i;
+    } else {
+      EXPECT_EQ(expected.erase(key) == 1, HashMap_remove(&map, &key));
+    }
+  }
+
+  ASSERT_EQ(expected.size(), map.length);
+  for (int key = 0; key < 3000; ++key) {
+    long* value = (long*) HashMap_get(&map, &key);
+    if (expected.count(key)) {
+      ASSERT_TRUE(value != NULL);
+      EXPECT_EQ(expected[key], *value);
+    } else {
+      EXPECT_EQ(NULL, value);
+    }
+  }
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(HashMapMethods, ChurnDoesNotGrowTheTable) {
+  HashMap_reserve(&map, 100, &se);
+  size_t capacity = map._capacity;
+  long value = 0;
+  for (int key = 0; key < 100000; ++key) {
+    HashMap_put(&map, &key, &value, &se);
+    HashMap_remove(&map, &key);
+  }
+  EXPECT_EQ(capacity, map._capacity);
+  EXPECT_EQ(0, map.length);
+}
+
+TEST_F(HashMapMethods, NextVisitsEveryEntry) {
+  long total = 0;
+  for (int key = 0; key < 100; ++key) {
+    long value = key;
+    HashMap_put(&map, &key, &value, &se);
+  }
+  size_t iter = 0;
+  void* key;
+  void* value;
+  while (HashMap_next(&map, &iter, &key, &value)) {
+    EXPECT_EQ(*(int*) key, *(long*) value);
+    total += *(long*) value;
+  }
+  EXPECT_EQ(4950, total);
+}
+
+TEST_F(HashMapMethods, WorksAgainAfterADeinit) {
+  int key = 7;
+  long value = 70;
+  deinitHashMap(&map);
+  EXPECT_EQ(NULL, HashMap_get(&map, &key));
+  EXPECT_FALSE(HashMap_remove(&map, &key));
+  HashMap_clear(&map);
+  HashMap_reserve(&map, 100, &se);
+  EXPECT_LE(100, map._capacity);
+  deinitHashMap(&map);
+  HashMap_put(&map, &key, &value, &se);
+  EXPECT_FALSE(se.any);
+  EXPECT_EQ(70, *(long*) HashMap_get(&map, &key));
+}
+
+static void* failingCopy(void* to, const void* from, Err* se) {
+  se->any = true;
+  return to;
+}
+
+TEST_F(HashMapMethods, PutTakesTheKeyBackOutWhenTheValueCopyFails) {
+  int key = 1;
+  long value = 10;
+  HashMap_setValueInitializers(&map, failingCopy, NULL);
+  EXPECT_EQ(NULL, HashMap_put(&map, &key, &value, &se));
+  EXPECT_TRUE(se.any);
+  EXPECT_EQ(0, map.length);
+  EXPECT_FALSE(HashMap_contains(&map, &key));
+}
+
+class StringHashMapMethods : public ::testing::Test {
+public:
+  StringHashMapMethods() {
+    initStringHashMap(&map, sizeof(int), &se);
+  }
+
+  virtual ~StringHashMapMethods() {
+    deinitHashMap(&map);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  HashMap map = {};
+};
+
+TEST_F(StringHashMapMethods, CopiesKeysAndLooksUpByView) {
+  String key;
+  int value = 5;
+  initString(&key, "apple", &se);
+  HashMap_put(&map, &key, &value, &se);
+  deinitString(&key);
+
+  StringView view;
+  initStringView(&view, "apple pie", 5);
+  EXPECT_EQ(5, *(int*) HashMap_getView(&map, &view));
+  initStringView(&view, "apple pie", 9);
+  EXPECT_EQ(NULL, HashMap_getView(&map, &view));
+}
+
+TEST_F(StringHashMapMethods, RemoveDeinitializesTheKey) {
+  char buf[16];
+  for (int i = 0; i < 200; ++i) {
+    String key;
+    sprintf(buf, "key%d", i);
+    initString(&key, buf, &se);
+    HashMap_put(&map, &key, &i, &se);
+    if (i % 2) {
+      EXPECT_TRUE(HashMap_remove(&map, &key));
+    }
+    deinitString(&key);
+  }
+  EXPECT_EQ(100, map.length);
+}
+
+TEST(HashSetMethods, AddsEachKeyOnce) {
+  SystemErr se = S_E_CLEAR;
+  HashSet set;
+  initHashSet(&set, sizeof(long), NULL, NULL, &se);
+  long key = 42;
+  EXPECT_TRUE(HashSet_add(&set, &key, &se));
+  EXPECT_FALSE(HashSet_add(&set, &key, &se));
+  EXPECT_TRUE(HashSet_contains(&set, &key));
+  EXPECT_TRUE(HashSet_remove(&set, &key));
+  EXPECT_FALSE(HashSet_contains(&set, &key));
+  deinitHashSet(&set);
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "inlineList.h"
+}
+
+class InlineListMethods : public ::testing::Test {
+public:
+  InlineListMethods() {
+    initInlineList(&list, sizeof(int), NULL, NULL);
+  }
+
+  virtual ~InlineListMethods() {
+    deinitInlineList(&list);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  InlineList list = {};
+};
+
+static bool intEquals(int* firstInt, int* itemInt) {
+  return *firstInt == *itemInt;
+}
+
+TEST_F(InlineListMethods, StoresDataInTheNode) {
+  int item = 5;
+  InlineList_append(&list, &item, &se);
+  EXPECT_EQ((void*) list.firstNode->data, InlineList_first(&list));
+  EXPECT_EQ(5, *(int*) InlineList_first(&list));
+}
+
+TEST_F(InlineListMethods, FindReturnsPointerToValue) {
+  for (int i = 0; i < 5; ++i) {
+    InlineList_append(&list, &i, &se);
+  }
+  int item = 3;
+  LLErr llErr = LL_E_CLEAR;
+  int* found = (int*) InlineList_find(&list, &item, (bool (*)(void*, void*)) &intEquals,
+                                      &llErr);
+  EXPECT_EQ(LL_E_CLEAR, llErr);
+  EXPECT_EQ(3, *found);
+}
+
+TEST_F(InlineListMethods, RemovesFromBothEnds) {
+  for (int i = 0; i < 3; ++i) {
+    InlineList_prepend(&list, &i, &se);
+  }
+  InlineList_removeFirst(&list);
+  InlineList_removeLast(&list);
+  EXPECT_EQ(1, list.length);
+  EXPECT_EQ(1, *(int*) InlineList_first(&list));
+  EXPECT_EQ(list.firstNode, list.lastNode);
+}
+
+TEST(PooledInlineList, SharesAPoolWithAnotherList) {
+  SystemErr se = S_E_CLEAR;
+  NodePool pool;
+  InlineList a;
+  InlineList b;
+  initNodePool(&pool, InlineList_nodeSize(sizeof(double)), 0);
+  initInlineListPooled(&a, sizeof(double), NULL, NULL, &pool);
+  initInlineListPooled(&b, sizeof(double), NULL, NULL, &pool);
+  double item = 1.5;
+  InlineList_append(&a, &item, &se);
+  InlineList_append(&b, &item, &se);
+  EXPECT_EQ(1.5, *(double*) InlineList_last(&b));
+
+  deinitInlineList(&a);
+  deinitInlineList(&b);
+  deinitNodePool(&pool);
+}
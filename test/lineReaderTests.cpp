@@ -0,0 +1,56 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+extern "C" {
+  #include "lineReader.h"
+}
+
+class LineReaderMethods : public ::testing::Test {
+public:
+  LineReaderMethods() {
+    file = tmpfile();
+  }
+
+  virtual ~LineReaderMethods() {
+    deinitLineReader(&reader);
+    fclose(file);
+  }
+
+  void write(const char* contents, size_t bufSize) {
+    SystemErr se = S_E_CLEAR;
+    fputs(contents, file);
+    rewind(file);
+    initLineReader(&reader, file, bufSize, &se);
+    conditionallyRaiseErr(se);
+  }
+
+  std::string next() {
+    SystemErr se = S_E_CLEAR;
+    StringView line;
+    if (!LineReader_next(&reader, &line, &se)) {
+      return "<eof>";
+    }
+    return std::string(line.data, line.length);
+  }
+
+  FILE* file;
+  LineReader reader = {};
+};
+
+TEST_F(LineReaderMethods, ReadsLinesWithoutNewlines) {
+  write("one\ntwo\n\nthree", 0);
+  EXPECT_EQ("one", next());
+  EXPECT_EQ("two", next());
+  EXPECT_EQ("", next());
+  EXPECT_EQ("three", next());
+  EXPECT_EQ("<eof>", next());
+}
+
+TEST_F(LineReaderMethods, HandlesLinesSpanningBlocks) {
+  write("abcdef\nghijklmnopqrstuvwxyz\nz\n", 4);
+  EXPECT_EQ("abcdef", next());
+  EXPECT_EQ("ghijklmnopqrstuvwxyz", next());
+  EXPECT_EQ("z", next());
+  EXPECT_EQ("<eof>", next());
+}
@@ -104,3 +104,83 @@ TEST_F(LinkedListMethods, ClearSetsLengthTo0) {
   LinkedList_clear(&list);
   EXPECT_EQ(0, list.length);
 }
+
+TEST_F(LinkedListMethods, PrependOnEmptyListSetsLastNode) {
+  int item = 1;
+  LinkedList_prepend(&list, &item, &se);
+  EXPECT_EQ(list.firstNode, list.lastNode);
+}
+
+class PooledLinkedListMethods : public ::testing::Test {
+public:
+  PooledLinkedListMethods() {
+    initNodePool(&pool, LinkedList_poolSlotSize(sizeof(int)), 4);
+    initLinkedListPooled(&list, sizeof(int), NULL, NULL, &pool);
+  }
+
+  virtual ~PooledLinkedListMethods() {
+    deinitLinkedList(&list);
+    deinitNodePool(&pool);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  NodePool pool = {};
+  LinkedList list = {};
+};
+
+TEST_F(PooledLinkedListMethods, StoresDataRightAfterTheNode) {
+  int item = 7;
+  LinkedList_append(&list, &item, &se);
+  EXPECT_EQ(7, *(int*) LinkedList_first(&list));
+  EXPECT_LT((char*) list.firstNode, (char*) list.firstNode->data);
+  EXPECT_GE((char*) list.firstNode + pool.slotSize, (char*) list.firstNode->data + sizeof(int));
+}
+
+TEST_F(PooledLinkedListMethods, ReusesRemovedNodes) {
+  int item = 1;
+  LinkedList_append(&list, &item, &se);
+  SingleLinkedNode* first = list.firstNode;
+  LinkedList_removeFirst(&list);
+  LinkedList_prepend(&list, &item, &se);
+  EXPECT_EQ(first, list.firstNode);
+}
+
+TEST_F(PooledLinkedListMethods, GrowsPastOneChunk) {
+  for (int i = 0; i < 10; ++i) {
+    LinkedList_append(&list, &i, &se);
+  }
+  EXPECT_EQ(10, list.length);
+  EXPECT_EQ(9, *(int*) LinkedList_last(&list));
+  EXPECT_EQ(S_E_CLEAR, se);
+}
+
+static size_t listBytesHeld = 0;
+
+static void* countingAlloc(void*, size_t size) {
+  listBytesHeld += size;
+  return malloc(size);
+}
+
+static void* countingResize(void*, void* ptr, size_t oldSize, size_t size) {
+  listBytesHeld += size - oldSize;
+  return realloc(ptr, size);
+}
+
+static void countingRelease(void*, void* ptr, size_t size) {
+  listBytesHeld -= size;
+  free(ptr);
+}
+
+TEST(LinkedListWithAllocator, AllocatesEveryNodeFromIt) {
+  Allocator counting = {countingAlloc, countingResize, countingRelease, NULL};
+  SystemErr se = S_E_CLEAR;
+  LinkedList list;
+  initLinkedListWithAllocator(&list, sizeof(int), NULL, NULL, &counting);
+  for (int i = 0; i < 5; ++i) {
+    LinkedList_append(&list, &i, &se);
+  }
+  EXPECT_EQ(5 * LinkedList_poolSlotSize(sizeof(int)), listBytesHeld);
+  EXPECT_EQ(4, *(int*) LinkedList_last(&list));
+  deinitLinkedList(&list);
+  EXPECT_EQ(0, listBytesHeld);
+}
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+  #include "malloc.h"
+}
+
+class MemBufMethods : public ::testing::Test {
+public:
+  MemBufMethods() {
+    initMemBuf();
+    initiallyAvailable = MemBuf_available();
+  }
+
+  size_t initiallyAvailable;
+};
+
+TEST_F(MemBufMethods, AllocationsAreAlignedAndDisjoint) {
+  char* a = (char*) MemBuf_malloc(10);
+  char* b = (char*) MemBuf_malloc(1);
+  char* c = (char*) MemBuf_malloc(100);
+  ASSERT_TRUE(a && b && c);
+  EXPECT_EQ(0, (size_t) a % (2 * sizeof(size_t)));
+  EXPECT_EQ(0, (size_t) b % (2 * sizeof(size_t)));
+  memset(a, 'a', 10);
+  memset(b, 'b', 1);
+  memset(c, 'c', 100);
+  EXPECT_EQ('a', a[9]);
+  EXPECT_EQ('b', b[0]);
+  EXPECT_EQ('c', c[0]);
+}
+
+TEST_F(MemBufMethods, FreeingMergesNeighbors) {
+  void* a = MemBuf_malloc(100);
+  void* b = MemBuf_malloc(100);
+  void* c = MemBuf_malloc(100);
+  MemBuf_free(b);
+  MemBuf_free(a);
+  MemBuf_free(c);
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+  // Only fits if everything merged back into one block
+  EXPECT_TRUE(MemBuf_malloc(initiallyAvailable - 2 * sizeof(size_t)) != NULL);
+}
+
+TEST_F(MemBufMethods, ReturnsNullWhenFull) {
+  EXPECT_EQ(NULL, MemBuf_malloc(MALLOC_BUF_SIZE));
+  EXPECT_EQ(NULL, MemBuf_malloc((size_t) -1));
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, ReallocKeepsContents) {
+  char* str = (char*) MemBuf_malloc(6);
+  strcpy(str, "hello");
+  str = (char*) MemBuf_realloc(str, 300);
+  EXPECT_STREQ("hello", str);
+  str = (char*) MemBuf_realloc(str, 3);
+  EXPECT_EQ(0, memcmp("hel", str, 3));
+  MemBuf_free(str);
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, SurvivesRandomAllocationsAndFrees) {
+  std::vector<std::pair<unsigned char*, size_t>> live;
+  srand(5);
+  for (int i = 0; i < 20000; ++i) {
+    if (live.empty() || rand() % 2) {
+      size_t size = 1 + rand() % 120;
+      unsigned char* p = (unsigned char*) MemBuf_malloc(size);
+      if (p) {
+        memset(p, (unsigned char) size, size);
+        live.push_back(std::make_pair(p, size));
+      }
+    } else {
+      size_t at = rand() % live.size();
+      for (size_t j = 0; j < live[at].second; ++j) {
+        ASSERT_EQ((unsigned char) live[at].second, live[at].first[j]);
+      }
+      size_t size = 1 + rand() % 120;
+      unsigned char* p = rand() % 2 ? NULL :
+        (unsigned char*) MemBuf_realloc(live[at].first, size);
+      if (p) {
+        memset(p, (unsigned char) size, size);
+        live[at] = std::make_pair(p, size);
+      } else {
+        MemBuf_free(live[at].first);
+        live.erase(live.begin() + at);
+      }
+    }
+  }
+
+  for (auto& block : live) {
+    MemBuf_free(block.first);
+  }
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, ReallocGrowsIntoTheFreeBlockAfter) {
+  void* a = MemBuf_malloc(16);
+  void* b = MemBuf_malloc(200);
+  void* c = MemBuf_malloc(16);
+  MemBuf_free(b);
+  EXPECT_EQ(a, MemBuf_realloc(a, 150));
+  EXPECT_EQ(c, MemBuf_realloc(c, 500)); // Grows into the rest of the buffer
+  MemBuf_free(a);
+  MemBuf_free(c);
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, ReallocShrinksInPlace) {
+  void* a = MemBuf_malloc(400);
+  void* b = MemBuf_malloc(16);
+  size_t available = MemBuf_available();
+  EXPECT_EQ(a, MemBuf_realloc(a, 40));
+  EXPECT_LT(available, MemBuf_available());
+  // The freed tail is usable again
+  void* c = MemBuf_malloc(300);
+  EXPECT_LT((char*) a, (char*) c);
+  EXPECT_LT((char*) c, (char*) b);
+  MemBuf_free(a);
+  MemBuf_free(b);
+  MemBuf_free(c);
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, ReallocMovesWhenTheNextBlockIsUsed) {
+  char* a = (char*) MemBuf_malloc(16);
+  void* b = MemBuf_malloc(16);
+  strcpy(a, "moved");
+  char* moved = (char*) MemBuf_realloc(a, 100);
+  EXPECT_NE(a, moved);
+  EXPECT_STREQ("moved", moved);
+  MemBuf_free(b);
+  MemBuf_free(moved);
+  EXPECT_EQ(initiallyAvailable, MemBuf_available());
+}
+
+TEST_F(MemBufMethods, RepeatedGrowthRarelyMoves) {
+  char* arr = (char*) MemBuf_malloc(8);
+  char* first = arr;
+  int moves = 0;
+  for (size_t size = 16; size < 1500; size += 16) {
+    char* grown = (char*) MemBuf_realloc(arr, size);
+    ASSERT_TRUE(grown != NULL);
+    moves += grown != arr;
+    arr = grown;
+  }
+  EXPECT_EQ(first, arr);
+  EXPECT_EQ(0, moves);
+  MemBuf_free(arr);
+}
+
+TEST_F(MemBufMethods, FindsAFitPastTheHeadOfItsClass) {
+  void* a = MemBuf_malloc(192 - sizeof(size_t));
+  void* aFence = MemBuf_malloc(1);
+  void* b = MemBuf_malloc(144 - sizeof(size_t));
+  void* bFence = MemBuf_malloc(1);
+  void* rest = MemBuf_malloc(MemBuf_available() - sizeof(size_t));
+  ASSERT_TRUE(a && aFence && b && bFence && rest);
+  MemBuf_free(a);
+  MemBuf_free(b); // Now the head of the same class, and too small
+  EXPECT_EQ(a, MemBuf_malloc(168));
+}
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+extern "C" {
+  #include "mappedFile.h"
+}
+
+class MappedFileMethods : public ::testing::Test {
+public:
+  MappedFileMethods() {
+    int fd = mkstemp(path);
+    const char contents[] = "first\nsecond\n\nlast";
+    EXPECT_EQ(sizeof(contents) - 1, write(fd, contents, sizeof(contents) - 1));
+    close(fd);
+  }
+
+  virtual ~MappedFileMethods() {
+    deinitMappedFile(&file);
+    unlink(path);
+  }
+
+  char path[32] = "/tmp/mappedFileTestXXXXXX";
+  MappedFile file = {};
+};
+
+TEST_F(MappedFileMethods, MapsTheWholeFile) {
+  MappedFileErr e = S_E_CLEAR;
+  initMappedFile(&file, path, &e);
+  ASSERT_FALSE(e.any);
+  EXPECT_EQ(18, file.bytes.length);
+  EXPECT_EQ(0, memcmp("first\n", file.bytes.arr, 6));
+}
+
+TEST_F(MappedFileMethods, PopLineWalksEveryLine) {
+  MappedFileErr e = S_E_CLEAR;
+  StringView remaining;
+  StringView line;
+  initMappedFile(&file, path, &e);
+  MappedFile_advise(&file, MF_ADVICE_SEQUENTIAL, &e);
+  MappedFile_view(&file, &remaining);
+  int lines = 0;
+  while (StringView_popLine(&remaining, &line)) {
+    ++lines;
+  }
+  EXPECT_EQ(4, lines);
+  EXPECT_EQ(0, memcmp("last", line.data, line.length));
+  EXPECT_FALSE(e.any);
+}
+
+TEST_F(MappedFileMethods, UnknownAdviceIsAnError) {
+  MappedFileErr e = S_E_CLEAR;
+  initMappedFile(&file, path, &e);
+  MappedFile_advise(&file, (MappedFileAdvice) (MF_ADVICE_WILLNEED + 1), &e);
+  EXPECT_TRUE(e.any);
+  e = S_E_CLEAR;
+  MappedFile_advise(&file, (MappedFileAdvice) -1, &e);
+  EXPECT_TRUE(e.any);
+}
+
+TEST(MappedFile, MissingFileIsAnError) {
+  MappedFile file = {};
+  MappedFileErr e = S_E_CLEAR;
+  initMappedFile(&file, "/nonexistent/cPowers", &e);
+  EXPECT_TRUE(e.any);
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "nodePool.h"
+}
+
+class NodePoolMethods : public ::testing::Test {
+public:
+  NodePoolMethods() {
+    initNodePool(&pool, 20, 2);
+  }
+
+  virtual ~NodePoolMethods() {
+    deinitNodePool(&pool);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  NodePool pool = {};
+};
+
+TEST_F(NodePoolMethods, RoundsSlotsUpToAlignment) {
+  EXPECT_EQ(0, pool.slotSize % NODE_POOL_ALIGN);
+  EXPECT_GE(pool.slotSize, 20);
+}
+
+TEST_F(NodePoolMethods, HandsOutFreedSlotFirst) {
+  void* a = NodePool_alloc(&pool, &se);
+  void* b = NodePool_alloc(&pool, &se);
+  NodePool_free(&pool, a);
+  EXPECT_EQ(a, NodePool_alloc(&pool, &se));
+  EXPECT_NE(a, b);
+}
+
+TEST_F(NodePoolMethods, SlotsDontOverlap) {
+  char* a = (char*) NodePool_alloc(&pool, &se);
+  char* b = (char*) NodePool_alloc(&pool, &se);
+  char* c = (char*) NodePool_alloc(&pool, &se);
+  EXPECT_GE(std::abs(b - a), (long) pool.slotSize);
+  EXPECT_GE(std::abs(c - b), (long) pool.slotSize);
+  EXPECT_EQ(S_E_CLEAR, se);
+}
@@ -0,0 +1,139 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include "ringBuffer.h"
+}
+
+class SpscRingBufferMethods : public ::testing::Test {
+public:
+  SpscRingBufferMethods() {
+    initSpscRingBuffer(&ring, sizeof(long), 6, &se);
+  }
+
+  virtual ~SpscRingBufferMethods() {
+    deinitSpscRingBuffer(&ring);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  SpscRingBuffer ring;
+};
+
+TEST_F(SpscRingBufferMethods, RoundsCapacityToAPowerOfTwo) {
+  EXPECT_EQ(8, ring.capacity);
+}
+
+TEST_F(SpscRingBufferMethods, PushFailsWhenFullAndPopWhenEmpty) {
+  long item = 0;
+  EXPECT_FALSE(SpscRingBuffer_pop(&ring, &item));
+  for (long i = 0; i < 8; ++i) {
+    EXPECT_TRUE(SpscRingBuffer_push(&ring, &i));
+  }
+  EXPECT_FALSE(SpscRingBuffer_push(&ring, &item));
+  EXPECT_EQ(8, SpscRingBuffer_size(&ring));
+
+  EXPECT_TRUE(SpscRingBuffer_pop(&ring, &item));
+  EXPECT_EQ(0, item);
+  EXPECT_TRUE(SpscRingBuffer_push(&ring, &item));
+}
+
+TEST_F(SpscRingBufferMethods, StressKeepsOrderAcrossThreads) {
+  const long count = 200000;
+  std::thread producer([&] {
+    for (long i = 0; i < count; ++i) {
+      while (!SpscRingBuffer_push(&ring, &i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  long expected = 0;
+  long item;
+  while (expected < count) {
+    if (SpscRingBuffer_pop(&ring, &item)) {
+      ASSERT_EQ(expected++, item);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_EQ(0, SpscRingBuffer_size(&ring));
+}
+
+class MpmcRingBufferMethods : public ::testing::Test {
+public:
+  MpmcRingBufferMethods() {
+    initMpmcRingBuffer(&ring, sizeof(long), 64, &se);
+  }
+
+  virtual ~MpmcRingBufferMethods() {
+    deinitMpmcRingBuffer(&ring);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  MpmcRingBuffer ring;
+};
+
+TEST_F(MpmcRingBufferMethods, IsFifoFromOneThread) {
+  long item;
+  for (long i = 0; i < 64; ++i) {
+    EXPECT_TRUE(MpmcRingBuffer_push(&ring, &i));
+  }
+  EXPECT_FALSE(MpmcRingBuffer_push(&ring, &item));
+  for (long i = 0; i < 64; ++i) {
+    EXPECT_TRUE(MpmcRingBuffer_pop(&ring, &item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(MpmcRingBuffer_pop(&ring, &item));
+}
+
+TEST_F(MpmcRingBufferMethods, StressDeliversEveryElementOnce) {
+  const long perProducer = 50000;
+  const int threads = 4;
+  std::vector<std::vector<char>> seen(threads, std::vector<char>(perProducer));
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      for (long i = 0; i < perProducer; ++i) {
+        long item = t * perProducer + i;
+        while (!MpmcRingBuffer_push(&ring, &item)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<std::vector<long>> popped(threads);
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      long item;
+      while ((long) popped[t].size() < perProducer) {
+        if (MpmcRingBuffer_pop(&ring, &item)) {
+          popped[t].push_back(item);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (int t = 0; t < threads; ++t) {
+    long last[threads] = {-1, -1, -1, -1};
+    for (long item : popped[t]) {
+      // Each consumer sees any one producer's elements in order
+      ASSERT_LT(last[item / perProducer], item);
+      last[item / perProducer] = item;
+      seen[item / perProducer][item % perProducer]++;
+    }
+  }
+  for (int t = 0; t < threads; ++t) {
+    for (long i = 0; i < perProducer; ++i) {
+      ASSERT_EQ(1, seen[t][i]);
+    }
+  }
+}
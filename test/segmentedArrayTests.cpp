@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include "segmentedArray.h"
+}
+
+class SegmentedArrayMethods : public ::testing::Test {
+public:
+  SegmentedArrayMethods() {
+    initSegmentedArray(&arr, sizeof(int), 3);
+  }
+
+  virtual ~SegmentedArrayMethods() {
+    deinitSegmentedArray(&arr);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  SegmentedArray arr;
+};
+
+TEST_F(SegmentedArrayMethods, SegmentsDoubleInLength) {
+  size_t offset;
+  EXPECT_EQ(0, _SegmentedArray_segmentOf(&arr, 3, &offset));
+  EXPECT_EQ(3, offset);
+  EXPECT_EQ(1, _SegmentedArray_segmentOf(&arr, 4, &offset));
+  EXPECT_EQ(0, offset);
+  EXPECT_EQ(1, _SegmentedArray_segmentOf(&arr, 11, &offset));
+  EXPECT_EQ(7, offset);
+  EXPECT_EQ(2, _SegmentedArray_segmentOf(&arr, 12, &offset));
+  EXPECT_EQ(0, offset);
+}
+
+TEST_F(SegmentedArrayMethods, ElementsNeverMove) {
+  int* first = (int*) SegmentedArray_reserve(&arr, 0, &se);
+  *first = 42;
+  for (int i = 1; i < 10000; ++i) {
+    *(int*) SegmentedArray_reserve(&arr, i, &se) = i;
+  }
+  EXPECT_EQ(first, SegmentedArray_at(&arr, 0));
+  EXPECT_EQ(42, *first);
+  EXPECT_EQ(9999, *(int*) SegmentedArray_at(&arr, 9999));
+  EXPECT_FALSE(se.any);
+}
+
+TEST_F(SegmentedArrayMethods, StressConcurrentReserves) {
+  const int threads = 4;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      SystemErr reserveErr = S_E_CLEAR;
+      for (int i = t; i < 40000; i += threads) {
+        *(int*) SegmentedArray_reserve(&arr, i, &reserveErr) = i;
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (int i = 0; i < 40000; ++i) {
+    ASSERT_EQ(i, *(int*) SegmentedArray_at(&arr, i));
+  }
+}
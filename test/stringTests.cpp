@@ -18,13 +18,13 @@ class InitializationOfAString : public ::testing::Test {
 };
 
 TEST_F(InitializationOfAString, SuccessfullyExecutes) {
-  SystemErr eIgnore;
+  SystemErr eIgnore = S_E_CLEAR;
   initString(&str, "", &eIgnore);
   SUCCEED();
 }
 
 TEST_F(InitializationOfAString, HasCorrentLength) {
-  SystemErr eIgnore;
+  SystemErr eIgnore = S_E_CLEAR;
   initString(&str, "...", &eIgnore);
   EXPECT_EQ(str.length, 3);
 }
@@ -46,3 +46,182 @@ TEST_F(StringMethods, StringToiBase8Works) {
   int val = String_toi(&str, 8);
   EXPECT_EQ(8, val);
 }
+
+TEST_F(StringMethods, TokSplitsOnEveryDelimiter) {
+  SystemErr se = S_E_CLEAR;
+  Vector tokens = {};
+  initVector(&tokens, sizeof(String), NULL, (void (*)(void*)) &deinitString, &se);
+  Vector_catPrimitive(&str, "a bc,,d", 7, &se);
+  String_tok(&str, &tokens, " ,", &se);
+  ASSERT_EQ(3, tokens.length);
+  EXPECT_STREQ("bc", (char*) ((String*) tokens.arr)[1].arr);
+  EXPECT_STREQ("d", (char*) ((String*) tokens.arr)[2].arr);
+
+  deinitVector(&tokens);
+}
+
+TEST_F(InitializationOfAString, ShortContentsGetASmallBuffer) {
+  SystemErr eIgnore = S_E_CLEAR;
+  initString(&str, "token", &eIgnore);
+  EXPECT_EQ(16, str._arrSize);
+  EXPECT_STREQ("token", (char*) str.arr);
+}
+
+TEST_F(InitializationOfAString, CopyIsSizedToItsContents) {
+  SystemErr eIgnore = S_E_CLEAR;
+  String copy = {};
+  initString(&str, "", &eIgnore);
+  Vector_catPrimitive(&str, "abc", 3, &eIgnore);
+  initStringCp(&copy, &str, &eIgnore);
+  EXPECT_EQ(16, copy._arrSize);
+  EXPECT_STREQ("abc", (char*) copy.arr);
+
+  deinitString(&copy);
+}
+
+TEST_F(StringMethods, FindLocatesSubstringPastSimdBlocks) {
+  SystemErr se = S_E_CLEAR;
+  for (int i = 0; i < 10; ++i) {
+    Vector_catPrimitive(&str, "abcdefgh", 8, &se);
+  }
+  Vector_catPrimitive(&str, "needle", 6, &se);
+  EXPECT_EQ(80, String_find(&str, "needle", 0));
+  EXPECT_EQ(STRING_NPOS, String_find(&str, "needles", 0));
+  EXPECT_EQ(9, String_find(&str, "bcd", 2));
+}
+
+TEST_F(StringMethods, FindAnyReturnsFirstDelimiter) {
+  SystemErr se = S_E_CLEAR;
+  for (int i = 0; i < 40; ++i) {
+    Vector_catPrimitive(&str, "x", 1, &se);
+  }
+  Vector_catPrimitive(&str, "x;y,z", 5, &se);
+  EXPECT_EQ(41, String_findAny(&str, ",;", 0));
+  EXPECT_EQ(43, String_findAny(&str, ",;", 42));
+  EXPECT_EQ(STRING_NPOS, String_findAny(&str, "!", 0));
+}
+
+TEST_F(StringMethods, CountCountsNewlines) {
+  SystemErr se = S_E_CLEAR;
+  for (int i = 0; i < 100; ++i) {
+    Vector_catPrimitive(&str, "line\n", 5, &se);
+  }
+  EXPECT_EQ(100, String_count(&str, '\n'));
+}
+
+TEST_F(StringMethods, SplitKeepsEmptyFields) {
+  SystemErr se = S_E_CLEAR;
+  Vector fields = {};
+  initVector(&fields, sizeof(StringView), NULL, NULL, &se);
+  Vector_catPrimitive(&str, "a,,b,", 5, &se);
+  String_split(&str, &fields, ",", &se);
+  ASSERT_EQ(4, fields.length);
+  EXPECT_EQ(0, ((StringView*) fields.arr)[1].length);
+  EXPECT_EQ(0, ((StringView*) fields.arr)[3].length);
+
+  deinitVector(&fields);
+}
+
+TEST_F(StringMethods, CmpDoesntStopAtEmbeddedNul) {
+  SystemErr se = S_E_CLEAR;
+  String other = {};
+  initStringN(&other, "a\0b", 3, &se);
+  Vector_catPrimitive(&str, "a\0c", 3, &se);
+  EXPECT_GT(String_cmp(&str, &other), 0);
+  EXPECT_FALSE(String_equals(&str, &other));
+
+  deinitString(&other);
+}
+
+TEST_F(StringMethods, CmpOrdersPrefixFirst) {
+  SystemErr se = S_E_CLEAR;
+  String other = {};
+  initString(&other, "abc", &se);
+  Vector_catPrimitive(&str, "ab", 2, &se);
+  EXPECT_LT(String_cmp(&str, &other), 0);
+  EXPECT_GT(String_cmp(&other, &str), 0);
+
+  deinitString(&other);
+}
+
+TEST_F(StringMethods, EqualStringsHashTheSame) {
+  SystemErr se = S_E_CLEAR;
+  String other = {};
+  initString(&other, "the quick brown fox jumps over the lazy dog, twice over", &se);
+  Vector_cat(&str, &other, &se, &se);
+  EXPECT_TRUE(String_equals(&str, &other));
+  EXPECT_EQ(String_hash(&str), String_hash(&other));
+  Vector_removeLast(&str);
+  EXPECT_NE(String_hash(&str), String_hash(&other));
+
+  deinitString(&other);
+}
+
+TEST_F(StringMethods, StringToiAcceptsLowercaseHex) {
+  SystemErr se = S_E_CLEAR;
+  Vector_catPrimitive(&str, "ff", 2, &se);
+  EXPECT_EQ(255, String_toi(&str, 16));
+}
+
+TEST_F(StringMethods, StringToi64ParsesSignAndWhitespace) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector_catPrimitive(&str, " -9223372036854775808\n", 22, &se);
+  EXPECT_EQ(INT64_MIN, String_toi64(&str, 10, &pe));
+  EXPECT_FALSE(pe.any);
+}
+
+TEST_F(StringMethods, StringToi64ReportsOverflow) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector_catPrimitive(&str, "9223372036854775808", 19, &se);
+  String_toi64(&str, 10, &pe);
+  EXPECT_TRUE(pe.any);
+}
+
+TEST_F(StringMethods, StringTou64ParsesLongDigitRuns) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector_catPrimitive(&str, "18446744073709551615", 20, &se);
+  EXPECT_EQ(UINT64_MAX, String_tou64(&str, 10, &pe));
+  EXPECT_FALSE(pe.any);
+}
+
+TEST_F(StringMethods, StringTodRejectsTrailingGarbage) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector_catPrimitive(&str, "1.5x", 4, &se);
+  String_tod(&str, &pe);
+  EXPECT_TRUE(pe.any);
+}
+
+TEST_F(StringMethods, StringTodMatchesStrtod) {
+  const char* numbers[] = { "0.1", "-2.5e-3", "123456.789", "1e22", "3.14159265358979",
+                            "1e-300", "0x1p4", "12345678901234567890" };
+  for (const char* number : numbers) {
+    SystemErr se = S_E_CLEAR;
+    StringErrParse pe = S_E_CLEAR;
+    String num = {};
+    initString(&num, number, &se);
+    EXPECT_EQ(strtod(number, NULL), String_tod(&num, &pe)) << number;
+    EXPECT_FALSE(pe.any) << number;
+    deinitString(&num);
+  }
+}
+
+TEST_F(StringMethods, BatchToi64ParsesEveryString) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector tokens = {};
+  Vector ints = {};
+  initVector(&tokens, sizeof(String), NULL, (void (*)(void*)) &deinitString, &se);
+  initVector(&ints, sizeof(i64), NULL, NULL, &se);
+  Vector_catPrimitive(&str, "1,22,333", 8, &se);
+  String_tok(&str, &tokens, ",", &se);
+  String_batchToi64(&tokens, &ints, 10, &pe, &se);
+  ASSERT_EQ(3, ints.length);
+  EXPECT_EQ(333, ((i64*) ints.arr)[2]);
+
+  deinitVector(&ints);
+  deinitVector(&tokens);
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "stringVector.h"
+  #include "stringView.h"
+}
+
+class StringViewMethods : public ::testing::Test {
+public:
+  StringViewMethods() {
+    SystemErr se = S_E_CLEAR;
+    initVector(&views, sizeof(StringView), NULL, NULL, &se);
+    conditionallyRaiseErr(se);
+  }
+
+  virtual ~StringViewMethods() {
+    deinitVector(&views);
+  }
+
+  Vector views = {};
+};
+
+TEST_F(StringViewMethods, TokSkipsEmptyTokens) {
+  SystemErr se = S_E_CLEAR;
+  StringView line;
+  initStringView(&line, ",,ab, c,", 8);
+  StringView_tok(&line, &views, ", ", &se);
+  ASSERT_EQ(2, views.length);
+  StringView* tokens = (StringView*) views.arr;
+  EXPECT_EQ(line.data + 2, tokens[0].data);
+  EXPECT_EQ(2, tokens[0].length);
+  EXPECT_EQ(0, memcmp("c", tokens[1].data, tokens[1].length));
+}
+
+TEST_F(StringViewMethods, TokViewPointsIntoTheString) {
+  SystemErr se = S_E_CLEAR;
+  String str = {};
+  initString(&str, "GET /index.html HTTP/1.1", &se);
+  String_tokView(&str, &views, " ", &se);
+  ASSERT_EQ(3, views.length);
+  StringView* tokens = (StringView*) views.arr;
+  EXPECT_EQ((char*) str.arr + 4, tokens[1].data);
+  EXPECT_EQ(11, tokens[1].length);
+
+  deinitString(&str);
+}
+
+TEST_F(StringViewMethods, BatchTodStopsAtTheFirstBadNumber) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector doubles = {};
+  StringView line;
+  initVector(&doubles, sizeof(double), NULL, NULL, &se);
+  initStringView(&line, "1.5 2.25 oops 4", 15);
+  StringView_tok(&line, &views, " ", &se);
+  StringView_batchTod(&views, &doubles, &pe, &se);
+  EXPECT_TRUE(pe.any);
+  ASSERT_EQ(2, doubles.length);
+  EXPECT_EQ(2.25, ((double*) doubles.arr)[1]);
+
+  deinitVector(&doubles);
+}
+
+TEST_F(StringViewMethods, BatchParsingSkipsWhenAlreadyFailed) {
+  SystemErr se = S_E_CLEAR;
+  StringErrParse pe = S_E_CLEAR;
+  Vector ints = {};
+  initVector(&ints, sizeof(i64), NULL, NULL, &se);
+  pe.any = true;
+  StringView_batchToi64(&views, &ints, 10, &pe, &se); // No views at all
+  EXPECT_EQ(0, ints.length);
+
+  StringView line;
+  initStringView(&line, "1 2", 3);
+  StringView_tok(&line, &views, " ", &se);
+  StringView_batchToi64(&views, &ints, 10, &pe, &se);
+  EXPECT_EQ(0, ints.length);
+
+  deinitVector(&ints);
+}
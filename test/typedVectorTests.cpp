@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+extern "C" {
+  #include "stringVector.h"
+  #include "typedVector.h"
+  #include "vector.h"
+}
+
+DEFINE_VECTOR_ADVANCED(String, Strings, initStringCp, deinitString)
+
+class TypedVectorMethods : public ::testing::Test {
+public:
+  TypedVectorMethods() {
+    initInts(&ints, &se);
+  }
+
+  virtual ~TypedVectorMethods() {
+    deinitInts(&ints);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  Ints ints;
+};
+
+TEST_F(TypedVectorMethods, AddsPastTheInitialSize) {
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, *Ints_add(&ints, i, &se));
+  }
+  ASSERT_EQ(100, ints.vector.length);
+  EXPECT_EQ(99, *Ints_get(&ints, 99));
+  EXPECT_EQ(0, *Ints_get(&ints, 100)); // Null element
+}
+
+TEST_F(TypedVectorMethods, CatAndFillKeepTheNullElement) {
+  int nums[40];
+  for (int i = 0; i < 40; ++i) nums[i] = i + 1;
+  Ints_cat(&ints, nums, 40, &se);
+  Ints_fill(&ints, 7, 30, &se);
+  ASSERT_EQ(70, ints.vector.length);
+  EXPECT_EQ(0, memcmp(Ints_data(&ints), nums, sizeof(nums)));
+  EXPECT_EQ(7, *Ints_get(&ints, 69));
+  EXPECT_EQ(0, *Ints_get(&ints, 70));
+
+  Ints_removeLast(&ints);
+  EXPECT_EQ(69, ints.vector.length);
+  EXPECT_EQ(0, *Ints_get(&ints, 69));
+}
+
+TEST_F(TypedVectorMethods, WorksWithVectorFunctions) {
+  VectorErrRange e = S_E_CLEAR;
+  Ints_add(&ints, 3, &se);
+  int four = 4;
+  Vector_add(&ints.vector, &four, &se);
+  EXPECT_EQ(4, *(int*) Vector_at(&ints.vector, 1, &e));
+  EXPECT_EQ(4, *Ints_get(&ints, 1));
+
+  Doubles doubles;
+  initDoubles(&doubles, &se);
+  Doubles_add(&doubles, 1.5, &se);
+  EXPECT_EQ(sizeof(double), doubles.vector._typeSize);
+  EXPECT_EQ(1.5, *(double*) Vector_last(&doubles.vector, &e));
+  deinitDoubles(&doubles);
+}
+
+TEST_F(TypedVectorMethods, CopiesAndDeinitializesAdvancedElements) {
+  Strings strs;
+  String hello;
+  initStrings(&strs, &se);
+  initString(&hello, "Hello", &se);
+  String* added = Strings_add(&strs, hello, &se);
+  EXPECT_NE(hello.arr, added->arr);
+  Strings_fill(&strs, hello, 20, &se);
+  deinitString(&hello);
+
+  ASSERT_EQ(21, strs.vector.length);
+  EXPECT_STREQ("Hello", (char*) Strings_get(&strs, 20)->arr);
+  Strings_removeLast(&strs);
+  Vector_removeLast(&strs.vector); // Deinitializes through the Vector too
+  EXPECT_EQ(19, strs.vector.length);
+  deinitStrings(&strs);
+}
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+
+#include <deque>
+#include <stdlib.h>
+
+extern "C" {
+  #include "unrolledList.h"
+}
+
+class UnrolledListMethods : public ::testing::Test {
+public:
+  UnrolledListMethods() {
+    // Small chunks so the tests cross chunk boundaries
+    initUnrolledListAdvanced(&list, sizeof(int), 64, NULL, NULL);
+  }
+
+  virtual ~UnrolledListMethods() {
+    deinitUnrolledList(&list);
+  }
+
+  int at(size_t index) {
+    LLErr le = LL_E_CLEAR;
+    return *(int*) UnrolledList_at(&list, index, &le);
+  }
+
+  SystemErr se = S_E_CLEAR;
+  LLErr le = LL_E_CLEAR;
+  UnrolledList list = {};
+};
+
+TEST_F(UnrolledListMethods, AppendAndPrependAcrossChunks) {
+  for (int i = 0; i < 50; ++i) {
+    UnrolledList_append(&list, &i, &se);
+    int negative = -i - 1;
+    UnrolledList_prepend(&list, &negative, &se);
+  }
+  EXPECT_EQ(100, list.length);
+  EXPECT_EQ(-50, *(int*) UnrolledList_first(&list));
+  EXPECT_EQ(49, *(int*) UnrolledList_last(&list));
+  EXPECT_EQ(0, at(50));
+  EXPECT_NE(list.firstChunk, list.lastChunk);
+}
+
+TEST_F(UnrolledListMethods, AtOutOfRangeIsAnError) {
+  UnrolledList_at(&list, 0, &le);
+  EXPECT_EQ(LL_E_RANGE, le);
+}
+
+TEST_F(UnrolledListMethods, FindWithoutCmpComparesBytes) {
+  for (int i = 0; i < 40; ++i) {
+    UnrolledList_append(&list, &i, &se);
+  }
+  int item = 33;
+  EXPECT_EQ(33, *(int*) UnrolledList_find(&list, &item, NULL, &le));
+  item = 40;
+  UnrolledList_find(&list, &item, NULL, &le);
+  EXPECT_EQ(LL_E_NOT_FOUND, le);
+}
+
+TEST_F(UnrolledListMethods, MatchesADequeUnderRandomEdits) {
+  std::deque<int> expected;
+  srand(7);
+  for (int i = 0; i < 2000; ++i) {
+    int op = rand() % 4;
+    if (op < 2 || expected.empty()) {
+      size_t index = rand() % (expected.size() + 1);
+      UnrolledList_insertAt(&list, index, &i, &se, &le);
+      expected.insert(expected.begin() + index, i);
+    } else {
+      size_t index = rand() % expected.size();
+      UnrolledList_removeAt(&list, index, &le);
+      expected.erase(expected.begin() + index);
+    }
+  }
+
+  ASSERT_EQ(expected.size(), list.length);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], at(i));
+  }
+  EXPECT_EQ(LL_E_CLEAR, le);
+}
+
+static void sum(void* item, void* total) {
+  *(int*) total += *(int*) item;
+}
+
+TEST_F(UnrolledListMethods, ForEachVisitsEveryElement) {
+  for (int i = 1; i <= 30; ++i) {
+    UnrolledList_append(&list, &i, &se);
+  }
+  UnrolledList_removeFirst(&list);
+  UnrolledList_removeLast(&list);
+  int total = 0;
+  UnrolledList_forEach(&list, &sum, &total);
+  EXPECT_EQ(465 - 1 - 30, total);
+}
@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+extern "C" {
+  #include "stringVector.h"
+  #include "vector.h"
+  #include "vectorSort.h"
+}
+
+static int cmpInt(const void* a, const void* b) {
+  int x = *(const int*) a;
+  int y = *(const int*) b;
+  return (x > y) - (x < y);
+}
+
+struct Record {
+  int key;
+  int order;
+};
+
+static int cmpRecordKey(const void* a, const void* b) {
+  return cmpInt(&((const Record*) a)->key, &((const Record*) b)->key);
+}
+
+class VectorSortMethods : public ::testing::Test {
+public:
+  VectorSortMethods() {
+    srand(7);
+    initIntVector(&v, NULL, 0, &se);
+  }
+
+  virtual ~VectorSortMethods() {
+    deinitVector(&v);
+  }
+
+  // Fills [v] with [n] ints in [0, range) and keeps a copy in [expected]
+  void fill(size_t n, int range) {
+    Vector_clear(&v);
+    expected.clear();
+    for (size_t i = 0; i < n; ++i) {
+      int item = rand() % range - range / 2;
+      Vector_add(&v, &item, &se);
+      expected.push_back(item);
+    }
+    std::sort(expected.begin(), expected.end());
+  }
+
+  void expectSorted() {
+    ASSERT_EQ(expected.size(), v.length);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), (int*) v.arr));
+    EXPECT_EQ(0, *((int*) v.arr + v.length)); // Null element
+  }
+
+  SystemErr se = S_E_CLEAR;
+  Vector v;
+  std::vector<int> expected;
+};
+
+TEST_F(VectorSortMethods, SortsWithAComparator) {
+  for (size_t n : {0, 1, 2, 15, 17, 1000, 20000}) {
+    fill(n, 1 << 20);
+    Vector_sort(&v, cmpInt);
+    expectSorted();
+  }
+
+  fill(20000, 3); // Mostly duplicates
+  Vector_sort(&v, cmpInt);
+  expectSorted();
+}
+
+TEST_F(VectorSortMethods, HeapsortsWhenOutOfDepth) {
+  fill(1000, 1 << 20);
+  _VectorSort_intro((char*) v.arr, v.length, sizeof(int), cmpInt, 0);
+  expectSorted();
+}
+
+TEST_F(VectorSortMethods, StableSortKeepsTiesInOrder) {
+  Vector records;
+  initVector(&records, sizeof(Record), NULL, NULL, &se);
+  for (int i = 0; i < 5000; ++i) {
+    Record r = { rand() % 50, i };
+    Vector_add(&records, &r, &se);
+  }
+
+  Vector_stableSort(&records, cmpRecordKey, &se);
+  EXPECT_FALSE(se.any);
+  Record* r = (Record*) records.arr;
+  for (size_t i = 1; i < records.length; ++i) {
+    ASSERT_LE(r[i - 1].key, r[i].key);
+    if (r[i - 1].key == r[i].key) {
+      ASSERT_LT(r[i - 1].order, r[i].order);
+    }
+  }
+  deinitVector(&records);
+}
+
+TEST_F(VectorSortMethods, RadixSortsInts) {
+  fill(20000, 1 << 30);
+  int extremes[3] = { INT_MIN, INT_MAX, 0 };
+  Vector_catPrimitive(&v, extremes, 3, &se);
+  expected.insert(expected.end(), extremes, extremes + 3);
+  std::sort(expected.begin(), expected.end());
+  Vector_sortInts(&v, &se);
+  expectSorted();
+
+  fill(1000, 100); // Only the low byte differs
+  Vector_sortInts(&v, &se);
+  expectSorted();
+}
+
+TEST_F(VectorSortMethods, RadixSortsDoubles) {
+  Vector doubles;
+  std::vector<double> sorted;
+  initDoubleVector(&doubles, NULL, 0, &se);
+  for (int i = 0; i < 10000; ++i) {
+    double item = (rand() - RAND_MAX / 2) / 1000.0;
+    Vector_add(&doubles, &item, &se);
+    sorted.push_back(item);
+  }
+  double specials[4] = { -INFINITY, INFINITY, -0.0, 1e-300 };
+  Vector_catPrimitive(&doubles, specials, 4, &se);
+  sorted.insert(sorted.end(), specials, specials + 4);
+  std::sort(sorted.begin(), sorted.end());
+
+  Vector_sortDoubles(&doubles, &se);
+  ASSERT_EQ(sorted.size(), doubles.length);
+  EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), (double*) doubles.arr));
+  deinitVector(&doubles);
+}
+
+TEST_F(VectorSortMethods, SortsStringsByTheirBytes) {
+  Vector strs;
+  const char* words[] = { "banana", "", "apple", "app", "apple", "b", "ba",
+                          "applesauce", "zebra", "apricot" };
+  initVector(&strs, sizeof(String), NULL, (void (*)(void*)) &deinitString, &se);
+  for (int i = 0; i < 200; ++i) {
+    String* str = (String*) Vector_addEmpty(&strs, &se);
+    initString(str, words[i % 10], &se);
+    if (i % 7 == 0) {
+      Vector_add(str, "\0x", &se); // Embedded NULs sort by their byte
+    }
+  }
+
+  Vector_sortStrings(&strs);
+  String* s = (String*) strs.arr;
+  for (size_t i = 1; i < strs.length; ++i) {
+    ASSERT_LE(String_cmp(s + i - 1, s + i), 0) << i;
+  }
+  EXPECT_EQ(0, s[0].length);
+  deinitVector(&strs);
+}
+
+TEST_F(VectorSortMethods, ParallelSortMatchesSerial) {
+  for (uint threads : {2, 4}) {
+    fill(100000, 1 << 24);
+    Vector_parallelSort(&v, cmpInt, threads, &se);
+    EXPECT_FALSE(se.any);
+    expectSorted();
+  }
+
+  fill(50000, 4);
+  Vector_parallelSort(&v, cmpInt, 0, &se);
+  expectSorted();
+}
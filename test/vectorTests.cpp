@@ -79,3 +79,144 @@ TEST_F(VectorMethods, ReverseCompletes) {
   deinitVector(&reversed);
 }
 
+
+TEST_F(VectorMethods, CatPrimitiveCopiesAllElements) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[40];
+  for (int i = 0; i < 40; ++i) nums[i] = i;
+  Vector_catPrimitive(&v, nums, 40, &eIgnore);
+  ASSERT_EQ(40, v.length);
+  EXPECT_EQ(0, memcmp(v.arr, nums, sizeof(nums)));
+  EXPECT_EQ(0, *((int*) v.arr + 40));
+}
+
+static int rangeCopyCalls = 0;
+
+void* countingRangeCopyInitializer(void* dest, const void* src, size_t num,
+                                   SystemErr* err) {
+  rangeCopyCalls++;
+  return memcpy(dest, src, num * sizeof(int));
+}
+
+TEST_F(VectorMethods, CatUsesRangeCopyInitializerOncePerRange) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[3] = { 1, 2, 3 };
+  rangeCopyCalls = 0;
+  Vector_setRangeCopyInitializer(&v, &countingRangeCopyInitializer);
+  Vector_catPrimitive(&v, nums, 3, &eIgnore);
+  EXPECT_EQ(1, rangeCopyCalls);
+  EXPECT_EQ(3, *((int*) v.arr + 2));
+}
+
+TEST_F(VectorMethods, ReserveAvoidsGrowingWhileFilling) {
+  SystemErr eIgnore = S_E_CLEAR;
+  Vector_reserve(&v, 1000, &eIgnore);
+  void* arr = v.arr;
+  for (int i = 0; i < 1000; ++i) {
+    Vector_add(&v, &i, &eIgnore);
+  }
+  EXPECT_EQ(arr, v.arr);
+  EXPECT_EQ(999, *((int*) v.arr + 999));
+}
+
+TEST_F(VectorMethods, ShrinkToFitLeavesRoomForNullElement) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[3] = { 1, 2, 3 };
+  Vector_catPrimitive(&v, nums, 3, &eIgnore);
+  Vector_shrinkToFit(&v, &eIgnore);
+  EXPECT_EQ(4, v._arrSize);
+  EXPECT_EQ(3, *((int*) v.arr + 2));
+}
+
+TEST_F(VectorMethods, GrowthPolicyCapsStepSize) {
+  SystemErr eIgnore = S_E_CLEAR;
+  VectorGrowthPolicy policy = { 2, 1, 8, 0, 0 };
+  Vector_setGrowthPolicy(&v, &policy);
+  for (int i = 0; i < 16; ++i) {
+    Vector_add(&v, &i, &eIgnore);
+  }
+  EXPECT_EQ(24, v._arrSize);
+}
+
+TEST_F(VectorMethods, MoveTakesOverTheBuffer) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[3] = { 1, 2, 3 };
+  Vector_catPrimitive(&v, nums, 3, &eIgnore);
+  void* arr = v.arr;
+  Vector moved = {};
+  initVectorMove(&moved, &v);
+  EXPECT_EQ(arr, moved.arr);
+  EXPECT_EQ(3, moved.length);
+  EXPECT_EQ(NULL, v.arr);
+
+  deinitVector(&moved);
+}
+
+TEST_F(VectorMethods, AddMoveZeroesTheSource) {
+  SystemErr eIgnore = S_E_CLEAR;
+  Vector nested = {};
+  Vector inner = {};
+  initVector(&nested, sizeof(Vector), NULL, (void (*)(void*)) &deinitVector,
+             &eIgnore);
+  initVector(&inner, sizeof(int), NULL, NULL, &eIgnore);
+  void* innerArr = inner.arr;
+  Vector* added = (Vector*) Vector_addMove(&nested, &inner, &eIgnore);
+  EXPECT_EQ(innerArr, added->arr);
+  EXPECT_EQ(NULL, inner.arr);
+
+  deinitVector(&nested);
+}
+
+TEST_F(VectorMethods, GetSkipsTheRangeCheck) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[3] = { 1, 2, 3 };
+  Vector_catPrimitive(&v, nums, 3, &eIgnore);
+  EXPECT_EQ(2, *(int*) Vector_get(&v, 1));
+  VECTOR_GET(int, &v, 2) = 5;
+  EXPECT_EQ(5, *((int*) v.arr + 2));
+
+  int sum = 0;
+  int* el;
+  VECTOR_FOR_EACH(int, el, &v) {
+    sum += *el;
+  }
+  EXPECT_EQ(8, sum);
+}
+
+static void doubleInt(void* item, void* context) {
+  *(int*) item *= 2;
+  ++*(int*) context;
+}
+
+static void intToDouble(void* to, const void* from, void* context) {
+  *(double*) to = *(const int*) from + *(double*) context;
+}
+
+static void addInt(void* accumulator, const void* item, void* context) {
+  *(long*) accumulator += *(const int*) item;
+}
+
+TEST_F(VectorMethods, ForEachMapAndReduceWalkEveryElement) {
+  SystemErr eIgnore = S_E_CLEAR;
+  int nums[40];
+  for (int i = 0; i < 40; ++i) nums[i] = i;
+  Vector_catPrimitive(&v, nums, 40, &eIgnore);
+
+  int calls = 0;
+  Vector_forEach(&v, &doubleInt, &calls);
+  EXPECT_EQ(40, calls);
+  EXPECT_EQ(78, *((int*) v.arr + 39));
+
+  Vector doubles = {};
+  double offset = 0.5;
+  initVector(&doubles, sizeof(double), NULL, NULL, &eIgnore);
+  Vector_map(&v, &doubles, &intToDouble, &offset, &eIgnore);
+  ASSERT_EQ(40, doubles.length);
+  EXPECT_EQ(78.5, *((double*) doubles.arr + 39));
+  EXPECT_EQ(0, *((double*) doubles.arr + 40));
+  deinitVector(&doubles);
+
+  long sum = 0;
+  Vector_reduce(&v, &sum, &addInt, NULL);
+  EXPECT_EQ(39 * 40, sum);
+}